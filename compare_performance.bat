@@ -8,8 +8,8 @@ echo Running BASELINE (without optimizations)...
 echo.
 
 REM Build without optimizations
-g++ -std=c++17 -O2 -Iinclude src/main.cpp src/parser.cpp src/JSONSerializer.cpp src/JSONprinter.cpp src/JSONNavigator.cpp src/JSONPath.cpp src/FileUtils.cpp src/JSONUtils.cpp -o json_parser_baseline.exe
-g++ -std=c++17 -O2 -Iinclude src/benchmark.cpp src/parser.cpp src/JSONSerializer.cpp src/FileUtils.cpp src/JSONUtils.cpp -o benchmark_baseline.exe
+g++ -std=c++17 -O2 -Iinclude src/main.cpp src/parser.cpp src/JSONSerializer.cpp src/JSONprinter.cpp src/JSONNavigator.cpp src/JSONPath.cpp src/JSONPatch.cpp src/FileUtils.cpp src/JSONUtils.cpp src/StructuralIndex.cpp src/StringScan.cpp src/CPUFeatures.cpp src/JSONDocument.cpp src/JSONSnapshot.cpp src/DocumentCache.cpp src/JSONCursor.cpp src/NDJSON.cpp src/ParallelParser.cpp src/PushParser.cpp src/HTTPServer.cpp src/JSONService.cpp -lws2_32 -o json_parser_baseline.exe
+g++ -std=c++17 -O2 -Iinclude src/benchmark.cpp src/parser.cpp src/JSONSerializer.cpp src/FileUtils.cpp src/JSONUtils.cpp src/StructuralIndex.cpp src/StringScan.cpp src/CPUFeatures.cpp src/JSONDocument.cpp src/JSONSnapshot.cpp src/JSONCursor.cpp -o benchmark_baseline.exe
 
 echo Running baseline benchmarks...
 benchmark_baseline.exe bench_*.json > baseline_results.txt
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// ------------------------------------------------------------
+// ARENA (bump allocator)
+//
+// Hands out memory by bumping a pointer inside large blocks. Nothing
+// is freed individually: all blocks are released together when the
+// arena is destroyed, so tearing down everything allocated from it
+// costs O(number of blocks), not O(number of objects).
+//
+// Only trivially destructible objects may live in an arena, because
+// no destructors are ever run for them.
+// ------------------------------------------------------------
+class Arena {
+public:
+    explicit Arena(size_t firstBlockSize = 64 * 1024) : nextBlockSize(firstBlockSize) {}
+
+    // The moved-from arena is left empty, not pointing into blocks it
+    // no longer owns
+    Arena(Arena&& other) noexcept
+        : blocks(std::move(other.blocks)), cursor(other.cursor), limit(other.limit),
+          nextBlockSize(other.nextBlockSize), used(other.used) {
+        other.release();
+    }
+
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            blocks = std::move(other.blocks);
+            cursor = other.cursor;
+            limit = other.limit;
+            nextBlockSize = other.nextBlockSize;
+            used = other.used;
+            other.release();
+        }
+        return *this;
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        size_t misalign = reinterpret_cast<uintptr_t>(cursor) & (alignment - 1);
+        size_t padding = misalign ? alignment - misalign : 0;
+
+        if (cursor == nullptr || size_t(limit - cursor) < bytes + padding) {
+            grow(bytes + alignment);
+            misalign = reinterpret_cast<uintptr_t>(cursor) & (alignment - 1);
+            padding = misalign ? alignment - misalign : 0;
+        }
+
+        char* result = cursor + padding;
+        cursor = result + bytes;
+        used += bytes + padding;
+        return result;
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena objects are never destroyed");
+        if (count == 0)
+            return nullptr;
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Copies the characters into the arena (not NUL-terminated)
+    const char* copyString(std::string_view s) {
+        if (s.empty())
+            return "";
+        char* dst = static_cast<char*>(allocate(s.size(), 1));
+        std::memcpy(dst, s.data(), s.size());
+        return dst;
+    }
+
+    size_t bytesUsed() const { return used; }
+    size_t blockCount() const { return blocks.size(); }
+
+private:
+    void release() {
+        blocks.clear();
+        cursor = nullptr;
+        limit = nullptr;
+        used = 0;
+    }
+
+    // Block sizes double up to 4 MB, so a large document needs only a
+    // handful of blocks
+    void grow(size_t minBytes) {
+        size_t size = nextBlockSize;
+        if (size < minBytes)
+            size = minBytes;
+        if (nextBlockSize < 4 * 1024 * 1024)
+            nextBlockSize *= 2;
+
+        blocks.emplace_back(new char[size]);
+        cursor = blocks.back().get();
+        limit = cursor + size;
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t nextBlockSize;
+    size_t used = 0;
+};
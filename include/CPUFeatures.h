@@ -0,0 +1,31 @@
+#pragma once
+
+// ------------------------------------------------------------
+// Runtime CPU feature detection
+//
+// The SIMD kernels (structural index, string scanning) are compiled
+// for several instruction sets in the same binary using per-function
+// target attributes, and the fastest one the running CPU supports is
+// picked at runtime. This keeps the default build flags portable
+// (no -mavx2 needed) while still using AVX2 where available.
+// ------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSON_X86_SIMD 1
+#else
+#define JSON_X86_SIMD 0
+#endif
+
+#if JSON_X86_SIMD && (defined(__GNUC__) || defined(__clang__))
+#define JSON_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define JSON_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define JSON_TARGET_SSE42
+#define JSON_TARGET_AVX2
+#endif
+
+class CPUFeatures {
+public:
+    static bool hasSSE42();
+    static bool hasAVX2();
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "FileUtils.h"
+#include "ThreadPool.h"
+
+// ------------------------------------------------------------
+// DocumentCache — ON-DISK CACHE OF COMPILED DOCUMENTS
+//
+// Scripts run `json get` against the same unchanged file again and
+// again. With --cache, the first run parses the file and stores it as
+// a JSONSnapshot; later runs map the snapshot instead of re-parsing,
+// so a lookup costs a stat and an mmap whatever the file size.
+//
+// Each source path has one entry (a snapshot plus a small stamp file)
+// named after a hash of its absolute path. The stamp records the
+// source's size, modification time and content hash:
+//
+//   size + mtime match        hit, the source is not read at all
+//   size matches, mtime not   the source is hashed; same content is
+//                             still a hit (the stamp is refreshed)
+//   otherwise                 miss: parse, compile, replace the entry
+//
+// Entries are written to a temporary name and renamed into place, so
+// a concurrent reader sees the old entry or the new one, never half of
+// one. Nothing is evicted: an entry is replaced when its source
+// changes, and the directory can be deleted at any time.
+//
+// The directory is per user and must not be writable by anyone else;
+// when it isn't usable, or an entry can't be stored, the source file
+// is served uncached instead of failing the command.
+// ------------------------------------------------------------
+class DocumentCache {
+public:
+    // $JSON_CACHE_DIR, else json_parser in $XDG_CACHE_HOME or ~/.cache
+    DocumentCache();
+    explicit DocumentCache(std::filesystem::path directory);
+
+    // Mapped snapshot of the file's current contents, compiled and
+    // stored first on a miss (parse errors propagate unchanged). A
+    // file that already is a snapshot is mapped as is. `pool`, when
+    // given, parses a large root array in parallel on a miss.
+    std::shared_ptr<const MappedFile> map(const std::string& path, ThreadPool* pool = nullptr);
+
+    const std::filesystem::path& directory() const { return dir; }
+
+private:
+    struct Stamp {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+        uint64_t entrySize = 0;   // snapshot bytes, guards against a torn pair
+    };
+
+    std::filesystem::path dir;
+
+    bool privateDirectory() const;
+
+    static uint64_t contentHash(const MappedFile& file);
+    static bool readStamp(const std::filesystem::path& path, Stamp& stamp);
+    static void writeStamp(const std::filesystem::path& path, const Stamp& stamp);
+    static void writeAtomically(const std::filesystem::path& target, const std::string& bytes);
+};
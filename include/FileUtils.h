@@ -1,8 +1,63 @@
 #pragma once
+#include <functional>
+#include <memory>
+#include <ostream>
 #include <string>
+#include <string_view>
+
+// ------------------------------------------------------------
+// MappedFile — read-only view of a whole file
+//
+// The file is memory-mapped, so the parser reads straight out of the
+// page cache with no copy, and repeated CLI runs on the same file hit
+// warm pages. The view is always followed by at least `padding`
+// readable bytes, so scanners may load a full vector past the last
+// byte. When the page tail can't guarantee that (file size is a
+// multiple of the page size, or the file is empty), or the input is
+// not a regular file (a pipe, /dev/stdin), the contents are read once
+// into a padded heap buffer instead.
+// ------------------------------------------------------------
+class MappedFile {
+public:
+    static constexpr size_t padding = 64;
+
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(ptr, length); }
+
+    // false when the padded heap fallback was used
+    bool isMapped() const { return mapping != nullptr; }
+
+private:
+    const char* ptr = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr;
+    size_t mappedLength = 0;
+    std::unique_ptr<char[]> heap;
+};
 
 class FileUtils {
 public:
     static std::string readFile(const std::string& path);
+    static std::shared_ptr<const MappedFile> mapFile(const std::string& path);
     static void writeFile(const std::string& path, const std::string& content);
+
+    // Replaces bytes [begin, end) of the file. A replacement of the same
+    // length is written in place; otherwise the file is rewritten with
+    // writeReplacing (streamed, never held in memory). The file must not
+    // be mapped while this runs.
+    static void replaceRange(const std::string& path, size_t begin, size_t end, std::string_view replacement);
+
+    // Streams `produce` into a uniquely named temporary file next to
+    // `path` and moves it into place only if `produce` returns: an error
+    // leaves the old file untouched. The move renames over the
+    // symlink-resolved path with the original permissions, or copies
+    // back when the file has other hard links.
+    static void writeReplacing(const std::string& path, const std::function<void(std::ostream&)>& produce);
 };
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+struct HTTPRequest {
+    std::string method;
+    std::string path;                 // target without the query string
+    std::string query;
+    std::vector<std::pair<std::string, std::string>> headers;   // names lowercased
+    std::string body;
+    bool keepAlive = true;
+
+    // First header with this (lowercase) name, or empty
+    std::string_view header(std::string_view name) const;
+};
+
+struct HTTPResponse {
+    int status = 200;
+    std::string contentType = "application/json";
+    std::string body;
+};
+
+// Malformed or unacceptable request; answered with `status`, then the
+// connection is closed
+class HTTPError : public std::runtime_error {
+public:
+    int status;
+    HTTPError(int status, const std::string& msg) : std::runtime_error(msg), status(status) {}
+};
+
+// ------------------------------------------------------------
+// HTTPServer — MINIMAL HTTP/1.1 SERVER ON A THREAD POOL
+//
+// One thread polls the listening socket and every idle connection.
+// When a connection has data it leaves the poll set and is handed to a
+// pool worker, which reads and answers every complete request already
+// sent (pipelining works), then gives the connection back. Requests
+// are parsed and handled entirely in memory.
+//
+// Connections are kept alive (HTTP/1.1 default, or "Connection:
+// keep-alive" for 1.0) until the client closes them or they sit idle
+// for `idleTimeout`. Bodies need a Content-Length (chunked uploads are
+// refused with 411) and may be at most `maxBodyBytes`.
+//
+// An idle connection costs a socket and a buffer, not a worker, so a
+// small pool serves many keep-alive clients.
+// ------------------------------------------------------------
+class HTTPServer {
+public:
+    using Handler = std::function<HTTPResponse(const HTTPRequest&)>;
+
+    static constexpr size_t maxHeaderBytes = 64 * 1024;
+    static constexpr size_t maxBodyBytes = 256 * 1024 * 1024;
+    static constexpr std::chrono::seconds idleTimeout{30};
+
+    // The handler runs on pool threads, several requests at a time.
+    // The destructor waits for requests still being answered.
+    HTTPServer(Handler handler, ThreadPool& pool);
+    ~HTTPServer();
+
+    HTTPServer(const HTTPServer&) = delete;
+    HTTPServer& operator=(const HTTPServer&) = delete;
+
+    // Binds and listens; port 0 picks a free port. Returns the port.
+    uint16_t listen(const std::string& host, uint16_t port);
+
+    // Serves until stop() (callable from any thread)
+    void run();
+    void stop();
+
+    // One request from the front of `buffer`: bytes consumed, or 0 when
+    // the request is not complete yet. Throws HTTPError when malformed.
+    static size_t parseRequest(std::string_view buffer, HTTPRequest& request);
+
+    // Status line, headers and body
+    static std::string formatResponse(const HTTPResponse& response, bool keepAlive);
+
+private:
+    struct Connection;
+
+    Handler handler;
+    ThreadPool& pool;
+    intptr_t listener = -1;
+    intptr_t wakeRead = -1, wakeWrite = -1;   // loopback pair that interrupts poll
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> inFlight{0};          // connections being served by workers
+
+    std::mutex returnedMutex;
+    std::vector<std::unique_ptr<Connection>> returned;   // back from workers
+
+    void serve(std::unique_ptr<Connection> connection);
+    void giveBack(std::unique_ptr<Connection> connection);
+    void wake();
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser.h"
+#include "JSONPath.h"
+
+// Where one JSON value sits inside the source text
+struct ValueSpan {
+    size_t begin = 0;       // offset of the value's first byte
+    size_t end = 0;         // one past its last byte
+    int line = 1;           // line of `begin`
+    size_t lineStart = 0;   // offset of the first byte of that line
+};
+
+// ------------------------------------------------------------
+// JSONCursor — ON-DEMAND PATH LOOKUP
+//
+// Finds the value at a path without building a tree. Sibling values
+// that are not on the path are skipped by bracket/quote matching only:
+// no number conversion, no string unescaping, no allocation. Only the
+// target span is handed to the real parser afterwards.
+//
+// Skipped values are NOT validated (e.g. `[1, tru]` skips fine, only
+// bracket kinds must pair up); the target value itself is fully parsed
+// when it is materialized. Callers that write into a span use
+// locateChecked(), which validates the whole text first.
+// Lookup errors use the same messages as JSONNavigator.
+// ------------------------------------------------------------
+class JSONCursor {
+public:
+    // The text must outlive the cursor and every span it returns
+    explicit JSONCursor(std::string_view text) : text(text) {}
+
+    ValueSpan locate(const std::vector<PathElement>& path) const;
+
+    // locate() after a SAX pass over the whole text (no tree is built):
+    // a span that will be spliced must not come from malformed input
+    ValueSpan locateChecked(const std::vector<PathElement>& path) const;
+
+    // Raw JSON text of a located value
+    std::string_view slice(const ValueSpan& span) const {
+        return text.substr(span.begin, span.end - span.begin);
+    }
+
+    // Parses only the value at `path`
+    JSONValue get(const std::vector<PathElement>& path) const;
+
+    // Spans (with line numbers) of the root array's elements, found by
+    // skipping only. Returns false when the root is not an array or its
+    // top level is malformed; parse serially then to get the exact error.
+    bool rootElements(std::vector<ValueSpan>& elements) const;
+
+private:
+    std::string_view text;
+
+    size_t skipWhitespace(size_t i) const;
+    size_t skipString(size_t quote) const;     // returns one past the closing quote
+    size_t skipContainer(size_t open) const;   // returns one past the matching bracket
+    size_t skipScalar(size_t i) const;
+    size_t skipValue(size_t i) const;
+
+    size_t findMember(size_t open, const std::string& key) const;
+    size_t findElement(size_t open, int index) const;
+    bool keyEquals(size_t quote, size_t end, const std::string& key) const;
+
+    ValueSpan spanAt(size_t begin, size_t end) const;
+    [[noreturn]] void fail(const std::string& msg, size_t at) const;
+};
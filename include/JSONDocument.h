@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Arena.h"
+#include "FileUtils.h"
+#include "JSONCursor.h"
+#include "parser.h"
+
+// ------------------------------------------------------------
+// JSONDocument — ARENA-ALLOCATED, READ-ONLY JSON TREE
+//
+// JSONValue gives every node its own shared_ptr allocation, which is
+// convenient for editing but expensive to build and to destroy.
+// JSONDocument stores the same tree as plain structs inside an Arena:
+//
+//   - every DocValue is 16 bytes (type + length + payload)
+//   - the document owns the input text; strings and keys without escape
+//     sequences are views into it (zero copies, zero allocations), only
+//     escaped ones are decoded into the arena
+//   - arrays and object members are contiguous arena slices
+//   - object members keep their input order; of duplicate keys only the
+//     first is kept, as in JSONObject
+//   - destroying the document frees a few large blocks, nothing else
+//
+// Used by the read-only CLI commands; `set` still edits a JSONValue.
+// ------------------------------------------------------------
+
+struct DocMember;
+
+struct DocValue {
+    enum class Type : uint8_t { Null, Bool, Number, Integer, String, Array, Object };
+
+    Type type = Type::Null;
+    uint32_t length = 0;          // string bytes / element count / member count
+    union {
+        bool boolean;
+        double number;
+        int64_t integer;          // exact integer literals (Type::Integer)
+        const char* chars;
+        const DocValue* items;
+        const DocMember* members;
+    };
+
+    DocValue() : number(0) {}
+
+    // --- Accessors ---
+    bool isString() const { return type == Type::String; }
+    bool isNumber() const { return type == Type::Number || type == Type::Integer; }
+    bool isInteger() const { return type == Type::Integer; }
+    bool isBool()   const { return type == Type::Bool; }
+    bool isNull()   const { return type == Type::Null; }
+    bool isArray()  const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    std::string_view asString() const;
+    double asNumber() const;
+    int64_t asInteger() const;
+    bool asBool() const;
+
+    // Element / member count for arrays and objects
+    size_t size() const { return (isArray() || isObject()) ? length : 0; }
+
+    const DocValue& operator[](size_t index) const;
+    const DocMember& member(size_t index) const;
+
+    // Linear scan in input order; nullptr when the key is absent
+    const DocValue* find(std::string_view key) const;
+
+    // Deep copy into a mutable JSONValue tree; keys are interned in
+    // `keys` (or in a table of its own)
+    JSONValue toValue() const;
+    JSONValue toValue(KeyTable& keys) const;
+};
+
+struct DocMember {
+    std::string_view key;
+    DocValue value;
+};
+
+class JSONDocument {
+public:
+    // Empty document (root is null)
+    JSONDocument() = default;
+
+    // Single pass over the tokenizer (structural index enabled).
+    // Takes ownership of the text so string values can point into it;
+    // pass an rvalue to avoid copying the input.
+    static JSONDocument parse(std::string text);
+
+    // Parses a memory-mapped file in place; the document keeps the
+    // mapping alive for as long as its string views need it
+    static JSONDocument parse(std::shared_ptr<const MappedFile> file);
+
+    // Parses only one value of a mapped file, as found by JSONCursor;
+    // error positions still refer to the whole file
+    static JSONDocument parse(std::shared_ptr<const MappedFile> file, const ValueSpan& span);
+
+    const DocValue& root() const { return rootValue; }
+    std::string_view sourceText() const { return source; }
+
+    size_t arenaBytes() const { return arena.bytesUsed(); }
+    size_t arenaBlocks() const { return arena.blockCount(); }
+
+private:
+    friend class DocumentBuilder;
+    friend class ParallelParser;
+
+    static JSONDocument build(std::shared_ptr<const void> owner, std::string_view text,
+                              const ValueSpan& span);
+
+    // One batch of a parallel parse: the root is an array of the given
+    // root-array elements
+    static JSONDocument buildElements(std::shared_ptr<const void> owner, std::string_view text,
+                                      const ValueSpan* elements, size_t count);
+
+    // Concatenates the parts' root arrays into one root array; the parts
+    // (and their arenas) are kept alive inside the result
+    static JSONDocument join(std::shared_ptr<const void> owner, std::string_view text,
+                             std::vector<JSONDocument> parts);
+
+    std::shared_ptr<const void> sourceOwner;   // std::string or MappedFile
+    std::string_view source;                   // stable bytes the views point into
+    Arena arena;
+    std::vector<JSONDocument> parts;           // batches of a parallel parse
+    DocValue rootValue;
+};
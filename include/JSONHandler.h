@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// ------------------------------------------------------------
+// JSONHandler — SAX-style event interface
+//
+// Parser::parse(handler) walks the grammar and reports what it sees
+// as a flat stream of events instead of building a tree:
+//
+//   {"a": [1, true]}   →   startObject
+//                            key("a")
+//                            startArray
+//                              integer(1)
+//                              boolean(true)
+//                            endArray(2)
+//                          endObject(1)
+//
+// Nothing is allocated for the document itself, so aggregates,
+// filters and transcoders can process inputs far larger than a DOM
+// would fit in memory. Building a JSONValue or a JSONDocument is just
+// one more handler (JSONValueBuilder, DocumentBuilder).
+//
+// String views passed to key()/string() are only guaranteed valid
+// during the call; copy them if they must outlive it.
+// Every method defaults to doing nothing, so a handler only overrides
+// the events it cares about.
+//
+// Integer literals that fit in int64_t arrive as integer(); all other
+// numbers as number(). integer() forwards to number() by default, so
+// handlers that don't care about the difference only need number().
+// ------------------------------------------------------------
+class JSONHandler {
+public:
+    virtual ~JSONHandler() = default;
+
+    virtual void startObject() {}
+    virtual void key(std::string_view /*name*/) {}
+    virtual void endObject(size_t /*memberCount*/) {}
+
+    virtual void startArray() {}
+    virtual void endArray(size_t /*elementCount*/) {}
+
+    virtual void string(std::string_view /*value*/) {}
+    virtual void number(double /*value*/) {}
+    virtual void integer(int64_t value) { number(double(value)); }
+    virtual void boolean(bool /*value*/) {}
+    virtual void null() {}
+};
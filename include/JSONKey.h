@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// ------------------------------------------------------------
+// JSONKey — IMMUTABLE, SHAREABLE OBJECT KEY
+//
+// Arrays of records repeat the same few keys thousands of times. A
+// JSONKey is a pointer to one shared entry holding the text and its
+// precomputed hash, so every occurrence of "id" in a document can
+// point at the same storage:
+//
+//   - a key costs one pointer pair per member instead of a std::string
+//     (plus a heap block for long keys)
+//   - hashing a key never re-reads its text
+//   - two keys from the same KeyTable compare equal by pointer; other
+//     keys compare by hash first, then text. Path lookups (navigator,
+//     obj["k"]) take plain strings that are never interned, so they
+//     always take the hash-then-text route.
+//
+// A key built directly from a string (JSONKey("name")) gets its own
+// entry; KeyTable::intern() hands out shared ones.
+// ------------------------------------------------------------
+class JSONKey {
+public:
+    JSONKey() : entry(emptyEntry()) {}
+    JSONKey(std::string_view text) : entry(std::make_shared<const Entry>(text)) {}
+    JSONKey(const std::string& text) : JSONKey(std::string_view(text)) {}
+    JSONKey(const char* text) : JSONKey(std::string_view(text)) {}
+
+    const std::string& str() const { return entry->text; }
+    operator std::string_view() const { return entry->text; }
+    size_t hash() const noexcept { return entry->hash; }
+
+    // Same entry: both keys came from the same intern table
+    bool sharesStorageWith(const JSONKey& other) const { return entry == other.entry; }
+
+    bool operator==(const JSONKey& other) const {
+        return entry == other.entry
+            || (entry->hash == other.entry->hash && entry->text == other.entry->text);
+    }
+    bool operator!=(const JSONKey& other) const { return !(*this == other); }
+
+private:
+    struct Entry {
+        std::string text;
+        size_t hash;
+        explicit Entry(std::string_view t)
+            : text(t), hash(std::hash<std::string_view>()(t)) {}
+    };
+
+    static const std::shared_ptr<const Entry>& emptyEntry() {
+        static const std::shared_ptr<const Entry> empty = std::make_shared<const Entry>("");
+        return empty;
+    }
+
+    std::shared_ptr<const Entry> entry;
+};
+
+namespace std {
+// noexcept and cheap: hash tables need not store a copy of the hash
+template <>
+struct hash<JSONKey> {
+    size_t operator()(const JSONKey& key) const noexcept { return key.hash(); }
+};
+}
+
+// ------------------------------------------------------------
+// KeyTable — PER-DOCUMENT KEY INTERNING
+//
+// Used while building a tree: the first occurrence of a key creates
+// its entry, every later one shares it, so key storage grows with the
+// number of distinct keys, not with the number of members. The table
+// can be dropped once the tree is built; the keys keep their entries
+// alive.
+// ------------------------------------------------------------
+class KeyTable {
+public:
+    JSONKey intern(std::string_view text) {
+        auto it = keys.find(text);
+        if (it != keys.end())
+            return it->second;
+
+        JSONKey key(text);
+        keys.emplace(std::string_view(key.str()), key);   // view into the entry
+        return key;
+    }
+
+    size_t size() const { return keys.size(); }
+
+private:
+    std::unordered_map<std::string_view, JSONKey> keys;
+};
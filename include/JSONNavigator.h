@@ -1,8 +1,16 @@
 #pragma once
 #include "parser.h"
+#include "JSONDocument.h"
+#include "JSONSnapshot.h"
 #include "JSONPath.h"
 
 class JSONNavigator {
 public:
     static JSONValue& get(JSONValue& root, const std::vector<PathElement>& path);
+    static const DocValue& get(const DocValue& root, const std::vector<PathElement>& path);
+    static SnapValue get(const SnapValue& root, const std::vector<PathElement>& path);
+
+    // "true" / "false" / "null", a number, or a string (surrounding
+    // quotes removed): how `set` reads its value argument
+    static JSONValue valueFromString(const std::string& s);
 };
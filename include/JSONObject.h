@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "JSONKey.h"
+
+struct JSONValue;
+
+// ------------------------------------------------------------
+// JSONObject — INSERTION-ORDERED FLAT OBJECT
+//
+// Members live in one contiguous vector of (key, value) pairs, in the
+// order they were inserted (input order for parsed documents), so
+// building needs no per-member node and serialization walks memory
+// linearly and keeps the original key order.
+//
+// Most objects are small: up to `indexThreshold` members a lookup is a
+// linear scan comparing precomputed key hashes. Past that, the object
+// gets a compact open-addressing index (member positions, no copies of
+// the keys), created when the object first grows past the threshold
+// and kept up to date on insert. Lookups never modify the object, so
+// a finished tree can be read from several threads.
+//
+// Duplicate keys: the first occurrence wins, as in JSONDocument.
+// ------------------------------------------------------------
+class JSONObject {
+public:
+    using value_type = std::pair<JSONKey, std::shared_ptr<JSONValue>>;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    static constexpr size_t indexThreshold = 16;
+
+    iterator begin() { return members.begin(); }
+    iterator end() { return members.end(); }
+    const_iterator begin() const { return members.begin(); }
+    const_iterator end() const { return members.end(); }
+
+    size_t size() const { return members.size(); }
+    bool empty() const { return members.empty(); }
+    void reserve(size_t n) { members.reserve(n); }
+
+    // Interned keys match by pointer; plain strings are hashed once
+    iterator find(const JSONKey& key) { return begin() + lookup(key.hash(), key); }
+    const_iterator find(const JSONKey& key) const { return begin() + lookup(key.hash(), key); }
+    iterator find(std::string_view key) { return begin() + lookup(hashOf(key), key); }
+    const_iterator find(std::string_view key) const { return begin() + lookup(hashOf(key), key); }
+    iterator find(const std::string& key) { return find(std::string_view(key)); }
+    const_iterator find(const std::string& key) const { return find(std::string_view(key)); }
+    iterator find(const char* key) { return find(std::string_view(key)); }
+    const_iterator find(const char* key) const { return find(std::string_view(key)); }
+
+    template <class Key>
+    size_t count(const Key& key) const { return find(key) != end() ? 1 : 0; }
+
+    // Appends the member unless the key is already present
+    std::pair<iterator, bool> emplace(JSONKey key, std::shared_ptr<JSONValue> value) {
+        size_t existing = lookup(key.hash(), key);
+        if (existing != members.size())
+            return {begin() + existing, false};
+
+        members.emplace_back(std::move(key), std::move(value));
+        if (!slots.empty() || members.size() > indexThreshold)
+            indexMember(members.size() - 1);
+        return {begin() + (members.size() - 1), true};
+    }
+
+    // Removes one member; the ones after it keep their order. O(size).
+    iterator erase(const_iterator pos) {
+        size_t i = size_t(pos - members.cbegin());
+        members.erase(members.begin() + i);
+        if (members.size() > indexThreshold)
+            rebuildIndex();
+        else
+            slots.clear();
+        return begin() + i;
+    }
+
+private:
+    std::vector<value_type> members;
+    std::vector<uint32_t> slots;   // hash index: member position + 1, 0 = empty
+
+    static size_t hashOf(std::string_view text) { return std::hash<std::string_view>()(text); }
+
+    static bool matches(const JSONKey& member, size_t /*hash*/, const JSONKey& key) { return member == key; }
+    static bool matches(const JSONKey& member, size_t hash, std::string_view key) {
+        return member.hash() == hash && member.str() == key;
+    }
+
+    // Position of the member with this key, or size() when absent
+    template <class Key>
+    size_t lookup(size_t hash, const Key& key) const {
+        if (slots.empty()) {
+            for (size_t i = 0; i < members.size(); i++) {
+                if (matches(members[i].first, hash, key))
+                    return i;
+            }
+            return members.size();
+        }
+
+        size_t mask = slots.size() - 1;
+        for (size_t s = hash & mask; slots[s] != 0; s = (s + 1) & mask) {
+            size_t i = slots[s] - 1;
+            if (matches(members[i].first, hash, key))
+                return i;
+        }
+        return members.size();
+    }
+
+    // Keeps the index at most half full; grows by rebuilding it
+    void indexMember(size_t i) {
+        if (slots.size() < 2 * members.size()) {
+            rebuildIndex();
+            return;
+        }
+        place(i);
+    }
+
+    void rebuildIndex() {
+        size_t capacity = 64;
+        while (capacity < 2 * members.size())
+            capacity *= 2;
+        slots.assign(capacity, 0);
+        for (size_t m = 0; m < members.size(); m++)
+            place(m);
+    }
+
+    void place(size_t i) {
+        size_t mask = slots.size() - 1;
+        size_t s = members[i].first.hash() & mask;
+        while (slots[s] != 0)
+            s = (s + 1) & mask;
+        slots[s] = uint32_t(i + 1);
+    }
+};
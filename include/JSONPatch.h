@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include "parser.h"
+
+// ------------------------------------------------------------
+// JSONPatch — RFC 6902 OPERATION LISTS
+//
+// A patch is a JSON array of operations applied in order to one tree:
+//
+//   {"op": "add",     "path": "/a/b",  "value": ...}
+//   {"op": "remove",  "path": "/a/0"}
+//   {"op": "replace", "path": "/a",    "value": ...}
+//   {"op": "move",    "from": "/a", "path": "/b"}
+//   {"op": "copy",    "from": "/a", "path": "/b"}
+//   {"op": "test",    "path": "/a",    "value": ...}
+//
+// Paths are RFC 6901 JSON Pointers (JSONPath::parsePointer); "-" as the
+// last token of an add/move/copy target appends to an array. Members
+// added to an object go last, existing ones are replaced in place.
+// "test" compares structurally (numbers by value, object members in any
+// order).
+//
+// An operation that fails throws std::runtime_error naming its position
+// and op. The patch is not transactional: the document may already hold
+// the earlier operations, so callers discard it (the CLI writes nothing).
+// ------------------------------------------------------------
+class JSONPatch {
+public:
+    // Returns the number of operations applied
+    static size_t apply(JSONValue& document, const JSONValue& patch);
+};
@@ -11,4 +11,9 @@ struct PathElement {
 class JSONPath {
 public:
     static std::vector<PathElement> parse(const std::string& path);
+
+    // RFC 6901 JSON Pointer ("/a/0/b~1c") split into unescaped reference
+    // tokens; "" is the whole document. Whether a token is a key or an
+    // index depends on the value it is applied to, so it stays a string.
+    static std::vector<std::string> parsePointer(const std::string& pointer);
 };
@@ -1,16 +1,85 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <unordered_set>
+#include <vector>
 #include "parser.h"
+#include "JSONDocument.h"
+#include "JSONHandler.h"
+#include "JSONSnapshot.h"
 #include "JSONUtils.h"
+#include "JSONWriter.h"
 
+// Pretty output puts every element / member on its own line, indented
+// by two spaces per level; compact output has no whitespace at all.
 class JSONSerializer {
 public:
     static std::string serialize(const JSONValue& value, int indent = 0);
     static std::string serialize(const std::shared_ptr<JSONValue>& ptr, int indent = 0);
     static std::string serializeCompact(const JSONValue& value);
 
+    // Same output for the arena-backed document tree and for snapshots
+    static std::string serialize(const DocValue& value, int indent = 0);
+    static std::string serializeCompact(const DocValue& value);
+    static std::string serialize(const SnapValue& value, int indent = 0);
+    static std::string serializeCompact(const SnapValue& value);
+
+    // Append to a writer (and its sink) instead of returning a string
+    static void write(const JSONValue& value, JSONWriter& out, int indent = 0);
+    static void writeCompact(const JSONValue& value, JSONWriter& out);
+    static void write(const DocValue& value, JSONWriter& out, int indent = 0);
+    static void writeCompact(const DocValue& value, JSONWriter& out);
+    static void write(const SnapValue& value, JSONWriter& out, int indent = 0);
+    static void writeCompact(const SnapValue& value, JSONWriter& out);
+};
+
+// Re-serializes parser events as they arrive, so pretty/minify can
+// stream from input to output without building a tree. The output is
+// identical to JSONSerializer on the parsed document: as in the
+// builders, the first occurrence of a duplicate key wins and later ones
+// are dropped with their values.
+class SerializingHandler : public JSONHandler {
+public:
+    explicit SerializingHandler(JSONWriter& out, bool pretty = false) : out(out), pretty(pretty) {}
+
+    void startObject() override;
+    void key(std::string_view name) override;
+    void endObject(size_t memberCount) override;
+    void startArray() override;
+    void endArray(size_t elementCount) override;
+    void string(std::string_view value) override;
+    void number(double value) override;
+    void integer(int64_t value) override;
+    void boolean(bool value) override;
+    void null() override;
+
 private:
-    static std::string indentString(int indent);
+    struct Level {
+        size_t items = 0;      // written so far
+        size_t firstKey = 0;   // this object's keys start here in `keys`
+        bool wide = false;     // keys moved to wideKeys.back() instead
+        uint64_t seen = 0;     // one bit per key (length + first byte), to skip most scans
+    };
+
+    struct KeyRef {
+        size_t offset;
+        size_t size;
+    };
+
+    JSONWriter& out;
+    bool pretty;
+    bool afterKey = false;
+    std::vector<Level> open;
+    std::vector<KeyRef> keys;   // keys of the open objects, text in keyText
+    std::string keyText;
+    std::vector<std::unordered_set<std::string>> wideKeys;   // per wide open object
+    size_t skip = 0;            // > 0 while a duplicate member's value is dropped
+
+    bool duplicateKey(std::string_view name);
+    bool skipped(int nesting);
+    void nextItem();
+    void beginValue();
+    void close(char bracket);
 };
 
 // ------------------------------------------------------------
@@ -0,0 +1,27 @@
+#pragma once
+#include "HTTPServer.h"
+
+// ------------------------------------------------------------
+// JSONService — THE CLI COMMANDS AS HTTP ENDPOINTS
+//
+// Same routes and replies as scripts/server.py, answered in process:
+//
+//   POST /validate   body = JSON text
+//   POST /pretty     body = JSON text
+//   POST /minify     body = JSON text
+//   POST /show       body = JSON text
+//   POST /get        body = {"json": ..., "path": "a.b[0]"}
+//   POST /set        body = {"json": ..., "path": "...", "value": ...}
+//
+// Every reply is {"result": "...", "error": "..."}. A document that
+// fails to parse is a 200 with the error filled in (as the CLI's stderr
+// was); an empty body or missing field is a 400. In /get and /set,
+// "json" may be JSON text in a string or the document itself, and a
+// string "value" is read like the CLI argument (see
+// JSONNavigator::valueFromString). /set splices the value into JSON
+// text, keeping its formatting, and pretty-prints an inline document.
+// ------------------------------------------------------------
+class JSONService {
+public:
+    static HTTPResponse handle(const HTTPRequest& request);
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "FileUtils.h"
+#include "JSONDocument.h"
+
+// ------------------------------------------------------------
+// JSONSnapshot — COMPILED, MEMORY-MAPPABLE DOCUMENT
+//
+// `json compile` stores a parsed document in a binary form that is
+// read in place: loading a snapshot is mapping the file and checking
+// its header, with no tokenizing, parsing or allocation. Values are
+// then decoded lazily, only where get/show/minify actually look.
+//
+// Layout (native byte order, checked on load; offsets are from the
+// start of the file, so the file is position independent):
+//
+//   header   "JSONSNAP", version, byte-order tag, file size, root offset
+//   value    16 bytes: tag, length, payload
+//              null/bool/number/integer   payload = the value itself
+//              string                     payload = offset of `length` bytes
+//              array                      payload = offset of `length` values
+//              object                     payload = offset of `length` members
+//   member   32 bytes: key offset, key length, value
+//
+// Element and member tables are contiguous, so indexing is O(1) and
+// members keep the input order. Each distinct key is stored once.
+// Every offset is bounds-checked when it is followed, so a truncated
+// or corrupt file is reported as an error, never read out of range.
+// ------------------------------------------------------------
+
+enum class SnapTag : uint8_t { Null, Bool, Number, Integer, String, Array, Object };
+
+// On-disk value record
+struct SnapRecord {
+    SnapTag tag = SnapTag::Null;
+    uint8_t reserved[3] = {};
+    uint32_t length = 0;          // string bytes / element count / member count
+    uint64_t payload = 0;         // scalar bits or offset of the contents
+};
+
+// On-disk object member
+struct SnapMemberRecord {
+    uint64_t keyOffset = 0;
+    uint32_t keyLength = 0;
+    uint32_t reserved = 0;
+    SnapRecord value;
+};
+
+static_assert(sizeof(SnapRecord) == 16, "snapshot value records are 16 bytes");
+static_assert(sizeof(SnapMemberRecord) == 32, "snapshot member records are 32 bytes");
+
+struct SnapMember;
+
+// Read-only handle to one value inside a snapshot (cheap to copy).
+// Same accessors as DocValue, except that children are returned by
+// value instead of by reference.
+class SnapValue {
+public:
+    bool isString() const { return rec.tag == SnapTag::String; }
+    bool isNumber() const { return rec.tag == SnapTag::Number || rec.tag == SnapTag::Integer; }
+    bool isInteger() const { return rec.tag == SnapTag::Integer; }
+    bool isBool()   const { return rec.tag == SnapTag::Bool; }
+    bool isNull()   const { return rec.tag == SnapTag::Null; }
+    bool isArray()  const { return rec.tag == SnapTag::Array; }
+    bool isObject() const { return rec.tag == SnapTag::Object; }
+
+    std::string_view asString() const;
+    double asNumber() const;
+    int64_t asInteger() const;
+    bool asBool() const;
+
+    // Element / member count for arrays and objects
+    size_t size() const { return (isArray() || isObject()) ? rec.length : 0; }
+
+    SnapValue operator[](size_t index) const;
+    SnapMember member(size_t index) const;
+
+    // Linear scan in input order; empty when the key is absent
+    std::optional<SnapValue> find(std::string_view key) const;
+
+private:
+    friend class JSONSnapshot;
+
+    // Loads and checks the record at `offset`
+    SnapValue(const char* base, size_t fileSize, uint64_t offset);
+
+    // Start of the `length` entries of `width` bytes at the payload
+    // offset, bounds-checked; contents must come after the record
+    const char* table(size_t width) const;
+
+    const char* base;      // start of the file
+    size_t fileSize;
+    uint64_t offset;       // of this record
+    SnapRecord rec;
+};
+
+struct SnapMember {
+    std::string_view key;
+    SnapValue value;
+};
+
+class JSONSnapshot {
+public:
+    static constexpr uint32_t version = 1;
+
+    // True when the bytes start with the snapshot magic (never valid JSON)
+    static bool isSnapshot(std::string_view bytes);
+
+    // Checks the header of a mapped snapshot; throws when it is not a
+    // usable snapshot. The snapshot keeps the mapping alive.
+    static JSONSnapshot open(std::shared_ptr<const MappedFile> file);
+
+    // Snapshot bytes for a parsed document
+    static std::string compile(const DocValue& root);
+
+    SnapValue root() const;
+
+private:
+    std::shared_ptr<const MappedFile> file;
+    uint64_t rootOffset = 0;
+};
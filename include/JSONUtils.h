@@ -1,13 +1,24 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 
 class JSONUtils {
 public:
     // Escape string for valid JSON output
-    static std::string escapeString(const std::string& s);
+    static std::string escapeString(std::string_view s);
     
-    // Format number with proper precision
+    // Shortest round-trip form; integers print without a fraction and
+    // NaN / Infinity (not representable in JSON) print as null
     static std::string formatNumber(double value);
+
+    // Exact decimal form of a 64-bit integer
+    static std::string formatInteger(int64_t value);
+
+    // Same as above, appended straight to an output buffer (no temporaries)
+    static void appendEscaped(std::string& out, std::string_view s);
+    static void appendNumber(std::string& out, double value);
+    static void appendInteger(std::string& out, int64_t value);
 };
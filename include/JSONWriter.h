@@ -0,0 +1,96 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "JSONUtils.h"
+
+// ------------------------------------------------------------
+// JSONWriter — ONE GROWABLE OUTPUT BUFFER FOR ALL SERIALIZATION
+//
+// Every serializer writes into a single std::string; strings and
+// numbers are escaped/formatted straight into it, so no per-node
+// temporaries are created.
+//
+//   JSONWriter out;            collect everything, then take()
+//   JSONWriter out(buffer);    append to the caller's string
+//   JSONWriter out(sink);      hand each ~64 KB to `sink` (file, stdout,
+//                              socket...) so memory stays bounded;
+//                              call flush() at the end
+// ------------------------------------------------------------
+class JSONWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    JSONWriter() = default;
+    explicit JSONWriter(std::string& target) : buffer(&target) {}
+    explicit JSONWriter(Sink sink, size_t flushBytes = 64 * 1024)
+        : sink(std::move(sink)), flushBytes(flushBytes) {
+        own.reserve(flushBytes + 4096);
+    }
+
+    JSONWriter(const JSONWriter&) = delete;
+    JSONWriter& operator=(const JSONWriter&) = delete;
+
+    void put(char c) { buffer->push_back(c); }
+
+    void put(std::string_view text) {
+        buffer->append(text.data(), text.size());
+        flushIfFull();
+    }
+
+    // Quoted and escaped
+    void string(std::string_view text) {
+        buffer->push_back('"');
+        JSONUtils::appendEscaped(*buffer, text);
+        buffer->push_back('"');
+        flushIfFull();
+    }
+
+    void number(double value) {
+        JSONUtils::appendNumber(*buffer, value);
+        flushIfFull();
+    }
+
+    void integer(int64_t value) {
+        JSONUtils::appendInteger(*buffer, value);
+        flushIfFull();
+    }
+
+    // Newline followed by two spaces per level
+    void newline(int depth) {
+        static const char spaces[] = "                                                                ";
+        constexpr size_t chunk = sizeof(spaces) - 1;
+
+        buffer->push_back('\n');
+        for (size_t n = size_t(depth) * 2; n > 0; ) {
+            size_t step = n < chunk ? n : chunk;
+            buffer->append(spaces, step);
+            n -= step;
+        }
+        flushIfFull();
+    }
+
+    // Hands everything buffered so far to the sink (no-op without one)
+    void flush() {
+        if (sink && !buffer->empty()) {
+            sink(*buffer);
+            buffer->clear();
+        }
+    }
+
+    // Everything written so far (without a sink)
+    const std::string& str() const { return *buffer; }
+    std::string take() { return std::move(*buffer); }
+
+private:
+    std::string own;
+    std::string* buffer = &own;
+    Sink sink;
+    size_t flushBytes = 0;
+
+    void flushIfFull() {
+        if (sink && buffer->size() >= flushBytes)
+            flush();
+    }
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include "parser.h"
+#include "JSONDocument.h"
+#include "JSONSnapshot.h"
 #include "JSONUtils.h"
 #include <iostream>
 #include <string>
@@ -7,7 +9,10 @@
 class JSONPrinter {
 public:
     static void print(const JSONValue& value, int indent = 0);
+    static void print(const DocValue& value, int indent = 0);
+    static void print(const SnapValue& value, int indent = 0);
 
 private:
-    static void printIndent(int indent);
+    template <class Value>
+    static void printTree(const Value& value, int indent);
 };
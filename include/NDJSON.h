@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "JSONCursor.h"
+#include "ThreadPool.h"
+
+// ------------------------------------------------------------
+// NDJSON — newline-delimited JSON (JSON Lines)
+//
+// Every non-blank line is one independent JSON value. The input is cut
+// at newline boundaries into chunks of about `chunkBytes`; chunks are
+// processed on a ThreadPool and their output is emitted in input order.
+//
+// Line numbers are global: a first parallel pass counts the newlines
+// of every chunk, so each record knows its line before it is parsed.
+// ------------------------------------------------------------
+class NDJSON {
+public:
+    // Called for one record; `record` locates it inside the whole input
+    // (begin/end, line, lineStart) and output is appended to `out`.
+    // Runs on worker threads concurrently: it must not modify shared state.
+    using RecordFn = std::function<void(const ValueSpan& record, std::string& out)>;
+
+    // Receives each chunk's output, in input order, on the calling thread
+    using SinkFn = std::function<void(const std::string& chunkOutput)>;
+
+    static constexpr size_t chunkBytes = size_t(1) << 20;
+
+    // Returns the number of records. The first failing record (in input
+    // order) stops processing and its exception is rethrown; the output
+    // of every record before it has already been passed to `sink`.
+    static size_t forEachRecord(std::string_view text, ThreadPool& pool,
+                                const RecordFn& process, const SinkFn& sink);
+};
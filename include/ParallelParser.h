@@ -0,0 +1,34 @@
+#pragma once
+#include <memory>
+#include <string_view>
+
+#include "FileUtils.h"
+#include "JSONDocument.h"
+#include "ThreadPool.h"
+#include "parser.h"
+
+// ------------------------------------------------------------
+// ParallelParser — PARSES A LARGE ROOT ARRAY ON SEVERAL THREADS
+//
+// Big exports are usually one top-level array of independent records.
+// A skip-only walk (JSONCursor::rootElements) finds every element's
+// byte span, respecting strings and nesting; consecutive elements are
+// batched into ranges of about `rangeBytes` and each range is parsed on
+// the pool. The sub-results are stitched back together in order.
+//
+// Every element is tokenized with its real line/column, so errors are
+// the ones the serial parser would report for the first bad element.
+// Inputs that are not a well-formed root array, or too small to split,
+// are parsed serially.
+// ------------------------------------------------------------
+class ParallelParser {
+public:
+    static constexpr size_t rangeBytes = 256 * 1024;
+
+    // Editable tree; the root array's elements are parsed in parallel
+    static JSONValue parse(std::string_view text, ThreadPool& pool);
+
+    // Arena document over a mapped file; each range gets its own arena,
+    // which the returned document keeps alive
+    static JSONDocument parse(std::shared_ptr<const MappedFile> file, ThreadPool& pool);
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONHandler.h"
+#include "parser.h"
+
+// ------------------------------------------------------------
+// PushParser — INCREMENTAL PARSING OF INPUT THAT ARRIVES IN PIECES
+//
+// Parser pulls tokens from one complete buffer. PushParser is fed
+// chunks of any size instead (a socket read, a pipe read) and reports
+// SAX events to the handler as soon as the tokens behind them are
+// complete:
+//
+//   feed("{\"a\": [1, tr")   →  startObject, key("a"), startArray, integer(1)
+//   feed("ue]}")             →  boolean(true), endArray(2), endObject(1)
+//   finish()
+//
+// A chunk may end anywhere, even inside a string, number or keyword.
+// Everything up to the last complete token is lexed straight from the
+// chunk by the regular Tokenizer; only the unfinished token at its end
+// is copied and carried over to the next feed(). The memory held
+// between calls is therefore one token plus one small frame per open
+// container, however large the document is.
+//
+// The grammar is the same as Parser's, run as a state machine with an
+// explicit container stack, and errors are the same JSONParseError /
+// tokenizer errors, with line and column counted across chunks. After
+// an error the parser must not be fed again.
+//
+// By default the input is one root value. With `onValue` set, it is a
+// stream of root values (concatenated or newline-delimited JSON) and
+// onValue() runs after the last event of each one.
+// ------------------------------------------------------------
+class PushParser {
+public:
+    explicit PushParser(JSONHandler& handler, std::function<void()> onValue = nullptr);
+
+    // Parses as much of `chunk` as is complete. The chunk need not
+    // outlive the call.
+    void feed(std::string_view chunk);
+
+    // End of input: completes a trailing number or keyword and throws
+    // if a value is still open (or, in single-value mode, none was seen)
+    void finish();
+
+    // Root values completed so far
+    size_t valueCount() const { return values; }
+
+    // Bytes of the unfinished token carried between feed() calls
+    size_t pendingBytes() const { return pending.size(); }
+
+    // Same limit and error as Parser::setMaxDepth
+    void setMaxDepth(size_t depth) { maxDepth = depth; }
+
+private:
+    enum class Expect {
+        Value,          // a value (root, after ':' or after ',' in an array)
+        ValueOrEnd,     // after '['
+        KeyOrEnd,       // after '{'
+        Key,            // after ',' in an object
+        Colon,
+        CommaOrEnd,     // after a member or element
+        Nothing         // single-value mode, root complete
+    };
+
+    struct Frame {
+        bool object;
+        size_t count = 0;
+    };
+
+    JSONHandler& handler;
+    std::function<void()> onValue;
+
+    Expect expect = Expect::Value;
+    std::vector<Frame> stack;
+    size_t maxDepth = Parser::defaultMaxDepth;
+    size_t values = 0;
+
+    // Position of the next byte not yet lexed
+    int line = 1;
+    int column = 1;
+
+    // Unfinished token carried over from the previous chunk
+    std::string pending;
+    bool pendingString = false;    // it is a string (else a number/keyword)
+    bool pendingEscape = false;    // and ends in an unpaired backslash
+
+    void lex(std::string_view text, size_t from, size_t to);
+    void token(Token& t);
+    void valueDone();
+    void close();
+    [[noreturn]] void unexpected(const Token& t, const char* message);
+};
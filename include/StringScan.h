@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+// ------------------------------------------------------------
+// StringScan — VECTOR SEARCHES INSIDE STRING CONTENTS
+//
+// String bodies are mostly plain text; what matters is where the next
+// special byte is. These searches check 32 (AVX2) or 16 (SSE4.2) bytes
+// per step, with a scalar loop for the tail and for other CPUs. The
+// kernel is picked once at runtime (see CPUFeatures), so the caller
+// can copy or borrow everything before the hit in one go.
+//
+// Both return the offset of the first hit at or after `from`, or
+// `size` when there is none.
+// ------------------------------------------------------------
+class StringScan {
+public:
+    // Lexing: the closing quote or the next escape
+    static size_t findQuoteOrBackslash(const char* data, size_t from, size_t size);
+
+    // Output: the next byte that must be escaped ('"', '\\', < 0x20).
+    // Bytes >= 0x80 (UTF-8) never match.
+    static size_t findEscape(const char* data, size_t from, size_t size);
+};
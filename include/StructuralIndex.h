@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ------------------------------------------------------------
+// STRUCTURAL INDEX (stage 1 of the tokenizer)
+//
+// Scans the raw input 64 bytes at a time and records the offset of
+// every byte where a token starts:
+//   - structural characters  { } [ ] : ,   outside of strings
+//   - the opening quote of every string
+//   - the first byte of every scalar (number / true / false / null)
+//
+// Quotes, backslashes and in-string regions are resolved with bit
+// tricks on 64-bit masks, so whitespace and string contents are never
+// visited one byte at a time. The Tokenizer then jumps from one
+// indexed position to the next instead of calling advance() on every
+// whitespace byte.
+//
+// Byte classification has three implementations (AVX2, SSE4.2 and a
+// portable scalar loop); Backend::Auto picks the best one the CPU
+// supports at runtime. All backends produce identical indexes.
+// ------------------------------------------------------------
+class StructuralIndex {
+public:
+    enum class Backend { Auto, Scalar, SSE42, AVX2 };
+
+    // Offsets of all token starts, in increasing order.
+    // Input larger than 4 GB is rejected (offsets are 32-bit).
+    static std::vector<uint32_t> build(const char* data, size_t length,
+                                       Backend backend = Backend::Auto);
+
+    static bool isSupported(Backend backend);
+    static Backend bestBackend();
+    static const char* backendName(Backend backend);
+};
@@ -1,5 +1,6 @@
 #pragma once   //the function of this is that it prevents multiple inclusions of the same header file in a single compilation unit.
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -7,33 +8,54 @@
 #include <memory>
 #include <stdexcept>
 
-#include "token.h"   // only need token definitions here
+#include "token.h"
+#include "tokenizer.h"   // streaming mode pulls tokens straight from the tokenizer
+#include "JSONHandler.h"
+#include "JSONKey.h"
+#include "JSONObject.h"
 
 struct JSONValue; // forward declaring the structure
 
 using JSONArray = std::vector<std::shared_ptr<JSONValue>>;
-using JSONObject = std::unordered_map<std::string, std::shared_ptr<JSONValue>>;
 
 struct JSONValue : std::variant<
     std::string,
     double,
+    int64_t,
     bool,
     std::nullptr_t,
     JSONArray,
     JSONObject
 > {
-    using std::variant<std::string, double, bool, std::nullptr_t, JSONArray, JSONObject>::variant;
+    using std::variant<std::string, double, int64_t, bool, std::nullptr_t, JSONArray, JSONObject>::variant;
+
+    JSONValue() = default;
+    JSONValue(const JSONValue&) = default;
+    JSONValue(JSONValue&&) = default;
+    JSONValue& operator=(const JSONValue&) = default;
+    JSONValue& operator=(JSONValue&&) = default;
+
+    // Nested containers are released from a worklist, not by one nested
+    // destructor call per level, so tearing down a deep tree does not
+    // overflow the stack
+    ~JSONValue();
 
     // --- Accessors ---
+    // Integer literals that fit in 64 bits are stored exactly as int64_t;
+    // isNumber()/asNumber() cover both representations.
     bool isString() const { return std::holds_alternative<std::string>(*this); }
-    bool isNumber() const { return std::holds_alternative<double>(*this); }
+    bool isNumber() const { return std::holds_alternative<double>(*this) || isInteger(); }
+    bool isInteger() const { return std::holds_alternative<int64_t>(*this); }
     bool isBool()   const { return std::holds_alternative<bool>(*this); }
     bool isNull()   const { return std::holds_alternative<std::nullptr_t>(*this); }
     bool isArray()  const { return std::holds_alternative<JSONArray>(*this); }
     bool isObject() const { return std::holds_alternative<JSONObject>(*this); }
 
     const std::string& asString() const { return std::get<std::string>(*this); }
-    double asNumber() const { return std::get<double>(*this); }
+    double asNumber() const {
+        return isInteger() ? double(std::get<int64_t>(*this)) : std::get<double>(*this);
+    }
+    int64_t asInteger() const { return std::get<int64_t>(*this); }
     bool asBool() const { return std::get<bool>(*this); }
     const JSONArray& asArray() const { return std::get<JSONArray>(*this); }
     const JSONObject& asObject() const { return std::get<JSONObject>(*this); }
@@ -46,9 +68,10 @@ struct JSONValue : std::variant<
     JSONValue& operator[](const std::string& key) {
         if (!isObject()) throw std::runtime_error("Not a JSON object");
         auto& obj = std::get<JSONObject>(*this);
-        if (!obj.count(key))
-            obj[key] = std::make_shared<JSONValue>(nullptr);
-        return *obj[key];
+        auto it = obj.find(key);
+        if (it == obj.end())
+            it = obj.emplace(JSONKey(key), std::make_shared<JSONValue>(nullptr)).first;
+        return *it->second;
     }
 
     JSONValue& operator[](size_t index) {
@@ -77,23 +100,99 @@ public:
 // ----------------------
 // Parser
 // ----------------------
+// Two ways to feed the parser:
+//   Parser(tokens)    -> walks a pre-built vector<Token> (kept for callers
+//                        that already tokenized the input)
+//   Parser(tokenizer) -> single pass: pulls one token at a time from
+//                        Tokenizer::nextToken(), so no token vector is ever
+//                        materialized and peak memory is the JSONValue tree.
 class Parser {
 private:
     std::vector<Token> tokens;
     size_t pos = 0;
 
+    // Streaming mode state (source == nullptr in vector mode). The
+    // lookahead and the last consumed token live in two slots that swap
+    // roles on every advance(), so tokens are refilled, never moved.
+    Tokenizer* source = nullptr;
+    Token slots[2] = {Token(TokenType::END_OF_FILE), Token(TokenType::END_OF_FILE)};
+    unsigned ahead = 0;                        // slots[ahead] = next unconsumed token
+    bool consumedAny = false;
+
+    size_t maxDepth = defaultMaxDepth;
+
+    Token& lookahead() { return slots[ahead]; }
+    const Token& lookahead() const { return slots[ahead]; }
+    const Token& consumed() const { return slots[ahead ^ 1]; }
+
 public:
+    // Containers may nest this deep before parsing stops with a
+    // JSONParseError. Open levels live on a heap stack (a few bytes
+    // each), so the limit bounds memory, not native stack.
+    static constexpr size_t defaultMaxDepth = 1000000;
+
     Parser(const std::vector<Token>& t) : tokens(t) {}
+    explicit Parser(Tokenizer& tokenizer);
+
+    // Builds a JSONValue tree (a JSONValueBuilder driven by parse(handler))
     JSONValue parse();
 
+    // SAX mode: reports the document as events, builds nothing
+    void parse(JSONHandler& handler);
+
+    void setMaxDepth(size_t depth) { maxDepth = depth; }
+
 private:
     bool isAtEnd() const;
     const Token& peek() const;
-    const Token& advance();
-    void expect(TokenType type, const std::string& expectedMessage);
-    JSONValue parseValue();
-    JSONValue parseObject();
-    JSONValue parseArray();
+    Token& advance();
+    [[noreturn]] void throwEndOfInput(const std::string& message) const;
+    void expect(TokenType type, const char* expectedMessage);
+    void memberKey(JSONHandler& handler);
+};
+
+// ----------------------
+// JSONValueBuilder
+// ----------------------
+// SAX handler that assembles the events into a JSONValue tree.
+// Open containers wait on an explicit stack until their end event.
+// Object keys are interned: by default in a table of the builder's own,
+// or in a caller's table shared by several builds (one per document).
+class JSONValueBuilder : public JSONHandler {
+public:
+    explicit JSONValueBuilder(KeyTable* sharedKeys = nullptr)
+        : keys(sharedKeys ? sharedKeys : &ownKeys) {}
+
+    // `keys` may point at this builder's own table
+    JSONValueBuilder(const JSONValueBuilder&) = delete;
+    JSONValueBuilder& operator=(const JSONValueBuilder&) = delete;
+
+    void startObject() override;
+    void key(std::string_view name) override;
+    void endObject(size_t memberCount) override;
+    void startArray() override;
+    void endArray(size_t elementCount) override;
+    void string(std::string_view value) override;
+    void number(double value) override;
+    void integer(int64_t value) override;
+    void boolean(bool value) override;
+    void null() override;
+
+    // The completed root value (moved out)
+    JSONValue takeResult() { return std::move(result); }
+
+private:
+    struct Frame {
+        JSONValue container;
+        JSONKey pendingKey;       // objects: key of the value being parsed
+    };
+
+    void addValue(JSONValue value);
+
+    std::vector<Frame> stack;
+    JSONValue result;
+    KeyTable ownKeys;
+    KeyTable* keys;
 };
 
 
@@ -101,10 +200,11 @@ private:
 
 
 /* 
-====================== JSON PARSER — RECURSIVE DESCENT ======================
+====================== JSON PARSER — EXPLICIT-STACK DESCENT ===================
 
-This Parser consumes the list of tokens produced by Tokenizer and builds
-a recursive JSONValue tree using the following grammar:
+This Parser consumes the tokens produced by Tokenizer (either a pre-built
+vector or pulled on demand from nextToken()) and builds a recursive
+JSONValue tree using the following grammar:
 
 GRAMMAR (JSON Standard):
 
@@ -134,21 +234,30 @@ GRAMMAR (JSON Standard):
       → value
       | value ',' elements
 
-PARSER FUNCTIONS & WHAT THEY PARSE:
+HOW parse(handler) WALKS IT:
+
+  one loop alternates between two steps, with a stack of open containers
+  (object or array + members/elements seen so far) instead of recursion:
+
+  1) read one value  → a scalar is reported whole;
+                       '{' / '[' reports the start and pushes a frame
+                       (for an object, memberKey() reads "key" ':')
+  2) after a value   → ',' continues the innermost container;
+                       '}' / ']' pops it and reports its end, which
+                       completes one more value of the container below
 
-  parse()          → starts parsing at 'value'
-  parseValue()     → detects type (string/num/obj/arr/bool/null)
-  parseObject()    → parses {...} and key-value pairs recursively
-  parseArray()     → parses [...] and values recursively
+CONTROL FLOW EXAMPLE ({"a": [1]}):
+  - '{'  → startObject, push {object}, key("a")
+  - '['  → startArray, push {array}
+  - 1    → integer(1)
+  - ']'  → pop, endArray(1)      (completes the value of "a")
+  - '}'  → pop, endObject(1)     (stack empty: the root is done)
 
-CONTROL FLOW EXAMPLE:
-  - parse() calls parseValue()
-  - parseValue() sees '{' → calls parseObject()
-  - parseObject() sees key → calls parseValue() for its value
-  - nested objects/arrays trigger more recursive calls
+  Nesting is limited by setMaxDepth() (defaultMaxDepth levels).
 
-The output of parse() is a fully built JSONValue tree that
-matches the structure of the input JSON text.
+The parser only emits events (see JSONHandler.h). parse()
+without a handler plugs in a JSONValueBuilder and returns a fully built
+JSONValue tree that matches the structure of the input JSON text.
 
 =============================================================================
 */
@@ -165,14 +274,16 @@ JSONValue represents ANY JSON element using std::variant:
   JSONValue = variant<
       string,         // JSON string
       double,         // JSON number
+      int64_t,        // JSON integer literal that fits in 64 bits
       bool,           // true / false
       nullptr_t,      // null
       JSONArray,      // vector<shared_ptr<JSONValue>>
-      JSONObject      // unordered_map<string, shared_ptr<JSONValue>>
+      JSONObject      // ordered vector of (JSONKey, shared_ptr<JSONValue>)
   >
 
 ARRAY = JSONArray = vector<shared_ptr<JSONValue>>
-OBJECT = JSONObject = unordered_map<string, shared_ptr<JSONValue>>
+OBJECT = JSONObject = members in insertion order, hash index past 16 keys
+         (see JSONObject.h; JSONKey = shared, immutable key text + hash)
 
 REASONS FOR USING shared_ptr<JSONValue>:
   - Avoid copying large JSON subtrees
@@ -180,8 +291,8 @@ REASONS FOR USING shared_ptr<JSONValue>:
   - Makes operator[] easy: returns references into object/array
 
 ACCESSORS:
-  - isString(), isNumber(), isArray() ...
-  - asString(), asArray() ...
+  - isString(), isNumber(), isInteger(), isArray() ...
+  - asString(), asNumber(), asInteger(), asArray() ...
 
 OPERATOR[]:
   - obj["key"] gives reference to its JSONValue
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 
 enum class TokenType {
     LBRACE, RBRACE,
@@ -11,11 +14,66 @@ enum class TokenType {
 };
 
 // Representing one token: e.g. STRING("Ranveer"), NUMBER(20)
+//
+// Most tokens BORROW their text: `slice` points straight into the
+// tokenizer's input buffer and nothing is allocated. Only strings that
+// contained escape sequences own a decoded copy in `value`.
+// Borrowed tokens are valid as long as the input buffer is.
 struct Token {
     TokenType type;
-    std::string value;
+    std::string value;        // owned text (decoded escaped strings)
+    std::string_view slice;   // borrowed text (when `borrowed` is set)
+    bool borrowed = false;
+    double number = 0;        // converted value of a NUMBER token
+    int64_t integer = 0;      // exact value when `integral` is set
+    bool integral = false;    // NUMBER is an integer literal that fits in int64_t
     int line=1;
     int column=1;
-    Token(TokenType t, const std::string& v = "",int ln=1,int col=1)
-        : type(t), value(v), line(ln), column(col) {}
+    Token(TokenType t, std::string v = "",int ln=1,int col=1)
+        : type(t), value(std::move(v)), line(ln), column(col) {}
+
+    static Token borrow(TokenType t, std::string_view text, int ln, int col) {
+        Token token(t, std::string(), ln, col);
+        token.slice = text;
+        token.borrowed = true;
+        return token;
+    }
+
+    // Refills this token in place (Tokenizer::nextToken(Token&)), so a
+    // token slot can be reused without constructing a new Token
+    void assignBorrowed(TokenType t, std::string_view text, int ln, int col) {
+        type = t;
+        slice = text;
+        borrowed = true;
+        line = ln;
+        column = col;
+    }
+
+    std::string_view text() const {
+        return borrowed ? slice : std::string_view(value);
+    }
+
+    // Owned copy of the text; moves out of `value` when the token owns it
+    std::string takeString() {
+        return borrowed ? std::string(slice) : std::move(value);
+    }
 };
+
+// Friendly token type name (for error messages)
+inline std::string tokenTypeName(TokenType t) {
+    switch (t) {
+        case TokenType::LBRACE:   return "'{'";
+        case TokenType::RBRACE:   return "'}'";
+        case TokenType::LBRACKET: return "'['";
+        case TokenType::RBRACKET: return "']'";
+        case TokenType::COLON:    return "':'";
+        case TokenType::COMMA:    return "','";
+        case TokenType::STRING:   return "string";
+        case TokenType::NUMBER:   return "number";
+        case TokenType::TRUE:     return "'true'";
+        case TokenType::FALSE:    return "'false'";
+        case TokenType::NUL:      return "'null'";
+        case TokenType::END_OF_FILE: return "<EOF>";
+    }
+    return "token";
+}
@@ -1,20 +1,64 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include "token.h"
+#include "StringScan.h"
+#include "StructuralIndex.h"
 
 // Tokenizer with line + column tracking
+//
+// The tokenizer does not copy its input: it reads (and its tokens point
+// into) the caller's buffer, which must outlive the tokenizer and every
+// token it returns.
 class Tokenizer {
 private:
-    std::string input;
+    std::string_view input;
     size_t pos = 0;      // index into input
     int line = 1;        // current line number
-    int column = 1;      // current column number
+    size_t lineStart = 0; // offset of the first byte of the current line
+
+    // Structural index mode: token start offsets found by the SIMD pass
+    // (relative to structuralBase, the position the scan started from)
+    std::vector<uint32_t> structural;
+    size_t structuralBase = 0;
+    size_t nextStructural = 0;
+    bool indexed = false;
 
 public:
-    Tokenizer(const std::string& text) : input(text) {}
+    Tokenizer(std::string_view text) : input(text) {}
+
+    // Runs the vectorized stage-1 scan over the whole input. Afterwards
+    // nextToken() jumps straight to the next token start instead of
+    // walking whitespace byte by byte. Only JSON whitespace (space, \t,
+    // \n, \r) is skipped in this mode.
+    void enableStructuralIndex(StructuralIndex::Backend backend = StructuralIndex::Backend::Auto) {
+        structural = StructuralIndex::build(input.data() + pos, input.size() - pos, backend);
+        structuralBase = pos;
+        nextStructural = 0;
+        indexed = true;
+    }
+
+    // Starts tokenizing at `offset` (which must not be inside a string)
+    // instead of at 0. `atLine` / `atLineStart` describe that position
+    // so reported line/column numbers stay relative to the whole input.
+    // Call before enableStructuralIndex().
+    void seek(size_t offset, int atLine, size_t atLineStart) {
+        pos = offset;
+        line = atLine;
+        lineStart = atLineStart;
+        structural.clear();
+        nextStructural = 0;
+        indexed = false;
+    }
 
     inline bool isAtEnd() const {
         return pos >= input.size();
@@ -24,7 +68,18 @@ public:
         return isAtEnd() ? '\0' : input[pos];
     }
 
-    // Advance one character and update line + column
+    // Column is derived from the line start, so advancing only has to
+    // watch for newlines instead of bumping a counter on every byte
+    inline int column() const {
+        return int(pos - lineStart) + 1;
+    }
+
+    // Line of the next unread byte
+    inline int currentLine() const {
+        return line;
+    }
+
+    // Advance one character and update line tracking
     inline char advance() {
         if (isAtEnd())
             return '\0';
@@ -33,9 +88,7 @@ public:
 
         if (c == '\n') {
             line++;
-            column = 1;
-        } else {
-            column++;
+            lineStart = pos;
         }
 
         return c;
@@ -52,37 +105,106 @@ public:
         }
     }
 
+    static bool isJSONWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    // Index mode: moves nextStructural to the first token start >= pos
+    // and returns that offset (input.size() when there is none)
+    size_t nextIndexedStart() {
+        while (nextStructural < structural.size() && structuralBase + structural[nextStructural] < pos)
+            nextStructural++;
+        return nextStructural < structural.size() ? structuralBase + structural[nextStructural] : input.size();
+    }
+
+    // Index mode: jump over the gap to the next indexed token start,
+    // counting newlines in bulk. Gaps that are not pure whitespace
+    // (e.g. garbage glued to a number) are left for the normal dispatch
+    // so the error messages stay exactly the same.
+    void skipToNextStructural() {
+        // Minified input: the next token starts right here
+        if (isAtEnd() || !isJSONWhitespace(input[pos]))
+            return;
+
+        size_t target = nextIndexedStart();
+
+        size_t lastNewline = std::string_view::npos;
+        int newlines = 0;
+        for (size_t i = pos; i < target; i++) {
+            char c = input[i];
+            if (c == '\n') {
+                newlines++;
+                lastNewline = i;
+            } else if (c != ' ' && c != '\t' && c != '\r') {
+                skipWhitespace();
+                return;
+            }
+        }
+
+        if (newlines) {
+            line += newlines;
+            lineStart = lastNewline + 1;
+        }
+        pos = target;
+    }
+
+    // Index mode: the closing quote of the string opened just before pos
+    // is the last non-whitespace byte before the next indexed token start.
+    // Returns false (use the byte loop) if the string has escapes or the
+    // quote is missing.
+    bool indexedStringEnd(size_t& close) {
+        size_t end = nextIndexedStart();
+        while (end > pos && isJSONWhitespace(input[end - 1]))
+            end--;
+        if (end <= pos || input[end - 1] != '"')
+            return false;
+
+        close = end - 1;
+        return std::memchr(input.data() + pos, '\\', close - pos) == nullptr;
+    }
+
     // ====================================================
     // Main token dispatcher
     // ====================================================
     Token nextToken() {
-        skipWhitespace();
+        Token token(TokenType::END_OF_FILE);
+        nextToken(token);
+        return token;
+    }
+
+    // Same, but refills `out` in place: no Token is constructed and an
+    // escaped string is decoded into the capacity `out.value` already has
+    void nextToken(Token& out) {
+        if (indexed)
+            skipToNextStructural();
+        else
+            skipWhitespace();
 
         int tokenLine = line;
-        int tokenCol  = column;
+        int tokenCol  = column();
 
         if (isAtEnd())
-            return Token(TokenType::END_OF_FILE, "", tokenLine, tokenCol);
+            return out.assignBorrowed(TokenType::END_OF_FILE, std::string_view(), tokenLine, tokenCol);
 
         char c = advance();
 
         switch (c) {
-            case '{': return Token(TokenType::LBRACE,   "{", tokenLine, tokenCol);
-            case '}': return Token(TokenType::RBRACE,   "}", tokenLine, tokenCol);
-            case '[': return Token(TokenType::LBRACKET, "[", tokenLine, tokenCol);
-            case ']': return Token(TokenType::RBRACKET, "]", tokenLine, tokenCol);
-            case ':': return Token(TokenType::COLON,    ":", tokenLine, tokenCol);
-            case ',': return Token(TokenType::COMMA,    ",", tokenLine, tokenCol);
+            case '{': return out.assignBorrowed(TokenType::LBRACE,   input.substr(pos - 1, 1), tokenLine, tokenCol);
+            case '}': return out.assignBorrowed(TokenType::RBRACE,   input.substr(pos - 1, 1), tokenLine, tokenCol);
+            case '[': return out.assignBorrowed(TokenType::LBRACKET, input.substr(pos - 1, 1), tokenLine, tokenCol);
+            case ']': return out.assignBorrowed(TokenType::RBRACKET, input.substr(pos - 1, 1), tokenLine, tokenCol);
+            case ':': return out.assignBorrowed(TokenType::COLON,    input.substr(pos - 1, 1), tokenLine, tokenCol);
+            case ',': return out.assignBorrowed(TokenType::COMMA,    input.substr(pos - 1, 1), tokenLine, tokenCol);
 
             case '"':
-                return stringToken(tokenLine, tokenCol);
+                return stringToken(out, tokenLine, tokenCol);
         }
 
         if (isdigit(c) || c == '-')
-            return numberToken(c, tokenLine, tokenCol);
+            return numberToken(out, tokenLine, tokenCol);
 
         if (isalpha(c))
-            return keywordToken(c, tokenLine, tokenCol);
+            return keywordToken(out, tokenLine, tokenCol);
 
         throw std::runtime_error(
             "Unexpected character '" + std::string(1, c) +
@@ -111,93 +233,310 @@ public:
 //
 // VERY IMPORTANT FOR VALID JSON PARSING.
 // ------------------------------------------------------------
-    Token stringToken(int tokenLine, int tokenCol) {
-        std::string value;
-
-        while (!isAtEnd()) {
-            char c = advance();
-
-            if (c == '\\') {
-                if (isAtEnd())
-                    throw std::runtime_error("Invalid escape at end of string at line "
-                        + std::to_string(line) + ", column " + std::to_string(column));
-
-                char next = advance();
-                switch (next) {
-                    case '"':  value += '\"'; break;
-                    case '\\': value += '\\'; break;
-                    case '/':  value += '/';  break;
-                    case 'b':  value += '\b'; break;
-                    case 'f':  value += '\f'; break;
-                    case 'n':  value += '\n'; break;
-                    case 'r':  value += '\r'; break;
-                    case 't':  value += '\t'; break;
-
-                    default:
-                        throw std::runtime_error("Invalid escape sequence: \\" 
-                            + std::string(1, next) +
-                            " at line " + std::to_string(line) +
-                            ", column " + std::to_string(column));
-                }
+    void stringToken(Token& out, int tokenLine, int tokenCol) {
+        size_t start = pos;
+
+        // Fast path: escape-free string located through the structural
+        // index, borrowed from the input without scanning it byte by byte
+        size_t close;
+        if (indexed && indexedStringEnd(close)) {
+            countLines(pos, close);
+            pos = close + 1;
+            return out.assignBorrowed(TokenType::STRING, input.substr(start, close - start), tokenLine, tokenCol);
+        }
+
+        // Vector scan from one quote/backslash to the next: the string
+        // stays borrowed until the first escape; from then on the clean
+        // spans and the decoded escapes are appended to `out.value`
+        std::string& value = out.value;
+        bool hasEscapes = false;
+
+        while (true) {
+            size_t stop = StringScan::findQuoteOrBackslash(input.data(), pos, input.size());
+            countLines(pos, stop);   // raw newlines inside the string
+
+            if (stop >= input.size()) {
+                pos = input.size();
+                throw std::runtime_error("Unterminated string literal at line "
+                    + std::to_string(tokenLine) +
+                    ", column " + std::to_string(tokenCol));
+            }
+
+            if (!hasEscapes && input[stop] == '"') {
+                pos = stop + 1;
+                return out.assignBorrowed(TokenType::STRING, input.substr(start, stop - start), tokenLine, tokenCol);
+            }
+
+            if (!hasEscapes) {
+                value.clear();
+                hasEscapes = true;
             }
-            else if (c == '"') {
-                return Token(TokenType::STRING, value, tokenLine, tokenCol);
+            value.append(input.data() + pos, stop - pos);
+            pos = stop + 1;
+
+            if (input[stop] == '"') {
+                out.type = TokenType::STRING;
+                out.borrowed = false;
+                out.line = tokenLine;
+                out.column = tokenCol;
+                return;
             }
-            else {
-                value += c;
+
+            if (isAtEnd())
+                throw std::runtime_error("Invalid escape at end of string at line "
+                    + std::to_string(line) + ", column " + std::to_string(column()));
+
+            char next = advance();
+            switch (next) {
+                case '"':  value += '\"'; break;
+                case '\\': value += '\\'; break;
+                case '/':  value += '/';  break;
+                case 'b':  value += '\b'; break;
+                case 'f':  value += '\f'; break;
+                case 'n':  value += '\n'; break;
+                case 'r':  value += '\r'; break;
+                case 't':  value += '\t'; break;
+                case 'u':  unicodeEscape(value); break;
+
+                default:
+                    throw std::runtime_error("Invalid escape sequence: \\"
+                        + std::string(1, next) +
+                        " at line " + std::to_string(line) +
+                        ", column " + std::to_string(column()));
             }
         }
+    }
 
-        throw std::runtime_error("Unterminated string literal at line "
-            + std::to_string(tokenLine) +
-            ", column " + std::to_string(tokenCol));
+    // Advances line tracking over input[from, to) without touching pos
+    void countLines(size_t from, size_t to) {
+        const char* data = input.data();
+        for (const char* nl = static_cast<const char*>(std::memchr(data + from, '\n', to - from));
+             nl; nl = static_cast<const char*>(std::memchr(nl + 1, '\n', data + to - nl - 1))) {
+            line++;
+            lineStart = size_t(nl - data) + 1;
+        }
+    }
+
+    // \uXXXX (pos is just past the 'u'), appended as UTF-8. A high
+    // surrogate must be followed by an escaped low surrogate; the pair
+    // encodes one code point above U+FFFF.
+    void unicodeEscape(std::string& value) {
+        size_t escapeStart = pos - 2;
+        uint32_t codePoint = hexQuad(escapeStart);
+
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+            if (input.size() - pos < 2 || input[pos] != '\\' || input[pos + 1] != 'u')
+                invalidUnicode("Unpaired surrogate in unicode escape", escapeStart);
+            pos += 2;
+            uint32_t low = hexQuad(pos - 2);
+            if (low < 0xDC00 || low > 0xDFFF)
+                invalidUnicode("Unpaired surrogate in unicode escape", escapeStart);
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+            invalidUnicode("Unpaired surrogate in unicode escape", escapeStart);
+        }
+
+        if (codePoint < 0x80) {
+            value += char(codePoint);
+        } else if (codePoint < 0x800) {
+            value += char(0xC0 | (codePoint >> 6));
+            value += char(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            value += char(0xE0 | (codePoint >> 12));
+            value += char(0x80 | ((codePoint >> 6) & 0x3F));
+            value += char(0x80 | (codePoint & 0x3F));
+        } else {
+            value += char(0xF0 | (codePoint >> 18));
+            value += char(0x80 | ((codePoint >> 12) & 0x3F));
+            value += char(0x80 | ((codePoint >> 6) & 0x3F));
+            value += char(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // The four hex digits at pos
+    uint32_t hexQuad(size_t escapeStart) {
+        if (input.size() - pos < 4)
+            invalidUnicode("Invalid unicode escape", escapeStart);
+
+        uint32_t result = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = input[pos + i];
+            int digit = c >= '0' && c <= '9' ? c - '0'
+                      : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0)
+                invalidUnicode("Invalid unicode escape", escapeStart);
+            result = (result << 4) | uint32_t(digit);
+        }
+        pos += 4;
+        return result;
+    }
+
+    [[noreturn]] void invalidUnicode(const char* what, size_t escapeStart) const {
+        size_t length = std::min<size_t>(6, input.size() - escapeStart);
+        throw std::runtime_error(std::string(what) + ": " + std::string(input.substr(escapeStart, length)) +
+            " at line " + std::to_string(line) +
+            ", column " + std::to_string(int(escapeStart - lineStart) + 1));
     }
 
     // ====================================================
     // Parse NUMBER tokens
     // ====================================================
-    Token numberToken(char firstChar, int tokenLine, int tokenCol) {
-        std::string value(1, firstChar);
-        bool hasDecimal = false;
+    // Validates the full JSON grammar
+    //     -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)?
+    // and converts to double in the same pass: the decimal mantissa and
+    // exponent are collected while scanning, and when the mantissa fits
+    // in 53 bits and |exponent| <= 22 one exact multiply/divide gives
+    // the correctly rounded result (Clinger's fast path). Anything else
+    // goes through std::from_chars, which is exact.
+    //
+    // Integer literals (no fraction, no exponent) that fit in int64_t are
+    // also kept exactly in Token::integer; -0 stays a double so its sign
+    // survives a round trip.
+    void numberToken(Token& out, int tokenLine, int tokenCol) {
+        static constexpr double powersOf10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        size_t start = pos - 1;
+        const char* p = input.data() + start;
+        const char* end = input.data() + input.size();
+        auto isDigit = [&](const char* c) { return c < end && unsigned(*c - '0') < 10; };
+
+        bool negative = *p == '-';
+        if (negative)
+            p++;
+
+        uint64_t mantissa = 0;
+        int significantDigits = 0;   // digits in mantissa, leading zeros excluded
+        int exponent = 0;
+        auto addDigit = [&](char c) {
+            if (mantissa == 0 && c == '0')
+                return;
+            if (++significantDigits <= 19)
+                mantissa = mantissa * 10 + uint64_t(c - '0');
+        };
+
+        // Integer part: a single 0, or digits without a leading zero
+        if (!isDigit(p))
+            invalidNumber(start, p, tokenLine, tokenCol);
+        if (*p == '0') {
+            p++;
+            if (isDigit(p))
+                invalidNumber(start, p, tokenLine, tokenCol);
+        } else {
+            while (isDigit(p))
+                addDigit(*p++);
+        }
 
-        while (!isAtEnd()) {
-            char c = peek();
+        const char* integerEnd = p;
 
-            if (isdigit(c)) {
-                value += advance();
+        // Fraction
+        if (p < end && *p == '.') {
+            p++;
+            if (!isDigit(p))
+                invalidNumber(start, p, tokenLine, tokenCol);
+            while (isDigit(p)) {
+                addDigit(*p++);
+                exponent--;
             }
-            else if (c == '.' && !hasDecimal) {
-                hasDecimal = true;
-                value += advance();
+        }
+
+        // Exponent
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            bool negativeExponent = false;
+            if (p < end && (*p == '+' || *p == '-'))
+                negativeExponent = *p++ == '-';
+            if (!isDigit(p))
+                invalidNumber(start, p, tokenLine, tokenCol);
+
+            int value = 0;
+            while (isDigit(p)) {
+                if (value < 100000)
+                    value = value * 10 + (*p - '0');
+                p++;
             }
-            else break;
+            exponent += negativeExponent ? -value : value;
         }
 
-        if (value.back() == '.')
-            throw std::runtime_error("Invalid number format: " + value +
+        pos = size_t(p - input.data());
+        std::string_view text = input.substr(start, pos - start);
+
+        // The 19-digit mantissa can't overflow uint64_t; the sign allows
+        // one more on the negative side (INT64_MIN)
+        out.integral = p == integerEnd && significantDigits <= 19 && (negative
+            ? mantissa != 0 && mantissa <= uint64_t(INT64_MAX) + 1
+            : mantissa <= uint64_t(INT64_MAX));
+        if (out.integral)
+            out.integer = negative ? int64_t(0 - mantissa) : int64_t(mantissa);
+
+        double value;
+        if (significantDigits <= 19 && mantissa <= (uint64_t(1) << 53)
+            && exponent >= -22 && exponent <= 22) {
+            double m = double(mantissa);
+            value = exponent < 0 ? m / powersOf10[-exponent] : m * powersOf10[exponent];
+            if (negative)
+                value = -value;
+        } else {
+            value = slowNumber(text, tokenLine, tokenCol);
+        }
+
+        out.assignBorrowed(TokenType::NUMBER, text, tokenLine, tokenCol);
+        out.number = value;
+    }
+
+    // Exact conversion for the numbers the fast path can't take.
+    // Underflow is not an error: the correctly rounded result is a
+    // subnormal or ±0. Only a magnitude beyond DBL_MAX is rejected.
+    static double slowNumber(std::string_view text, int tokenLine, int tokenCol) {
+        double value = 0;
+#if defined(__cpp_lib_to_chars)
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec == std::errc())
+            return value;
+#endif
+        // from_chars reports underflow and overflow alike, and strtod
+        // sets ERANGE for both (and for subnormals), so the result's
+        // magnitude tells them apart
+        std::string copy(text);
+        value = std::strtod(copy.c_str(), nullptr);
+        if (std::isinf(value))
+            throw std::runtime_error("Number out of range: " + std::string(text) +
                 " at line " + std::to_string(tokenLine) +
                 ", column " + std::to_string(tokenCol));
+        return value;
+    }
 
-        return Token(TokenType::NUMBER, value, tokenLine, tokenCol);
+    [[noreturn]] void invalidNumber(size_t start, const char* stop, int tokenLine, int tokenCol) const {
+        // Include the offending character in the message
+        size_t length = size_t(stop - input.data()) - start + (stop < input.data() + input.size() ? 1 : 0);
+        throw std::runtime_error("Invalid number format: " + std::string(input.substr(start, length)) +
+            " at line " + std::to_string(tokenLine) +
+            ", column " + std::to_string(tokenCol));
     }
 
     // ====================================================
     // Parse keywords: true / false / null
     // ====================================================
-    Token keywordToken(char firstChar, int tokenLine, int tokenCol) {
-        std::string word(1, firstChar);
+    void keywordToken(Token& out, int tokenLine, int tokenCol) {
+        size_t start = pos - 1;
+
+        while (!isAtEnd() && isalpha(static_cast<unsigned char>(input[pos])))
+            pos++;
 
-        while (!isAtEnd() && isalpha(peek()))
-            word += advance();
+        std::string_view word = input.substr(start, pos - start);
 
         if (word == "true")
-            return Token(TokenType::TRUE, word, tokenLine, tokenCol);
+            return out.assignBorrowed(TokenType::TRUE, word, tokenLine, tokenCol);
         if (word == "false")
-            return Token(TokenType::FALSE, word, tokenLine, tokenCol);
+            return out.assignBorrowed(TokenType::FALSE, word, tokenLine, tokenCol);
         if (word == "null")
-            return Token(TokenType::NUL, word, tokenLine, tokenCol);
+            return out.assignBorrowed(TokenType::NUL, word, tokenLine, tokenCol);
 
-        throw std::runtime_error("Unexpected keyword \"" + word +
+        throw std::runtime_error("Unexpected keyword \"" + std::string(word) +
             "\" at line " + std::to_string(tokenLine) +
             ", column " + std::to_string(tokenCol));
     }
@@ -244,19 +583,27 @@ HOW TOKENIZATION WORKS (STEP-BY-STEP):
 
 5. If a '"' is seen:
       begin reading a STRING
-      read characters until next '"'
-      (later improvements: handle escape sequences)
+      jump to the next '"' or '\' with a vector scan (StringScan)
+      escape sequences, \uXXXX and surrogate pairs are decoded to UTF-8
 
 6. If a digit or '-' starts:
       read characters of NUMBER
-      supports integers and decimals
+      full JSON grammar (sign, fraction, exponent), converted to
+      double in the same pass (Token::number); integer literals
+      that fit also kept exactly (Token::integer)
 
 7. If 't', 'f', or 'n' appears:
       read literal true / false / null
 
 8. If unknown character appears → throw error
 
-The output is a flat vector<Token> which the Parser reads sequentially.
+With enableStructuralIndex(), step 1 is replaced by a SIMD pre-pass
+(see StructuralIndex.h) that records every token start; nextToken()
+then jumps from one recorded offset to the next.
+
+The Parser pulls tokens one at a time through nextToken() (single pass,
+no intermediate storage); tokenize() still returns the whole flat
+vector<Token> for callers that want it.
 
 ======================================================================
 */
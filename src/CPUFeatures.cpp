@@ -0,0 +1,40 @@
+#include "../include/CPUFeatures.h"
+
+#if JSON_X86_SIMD && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if JSON_X86_SIMD && defined(_MSC_VER) && !defined(__clang__)
+// MSVC has no __builtin_cpu_supports: read CPUID directly
+static bool cpuidBit(int leaf, int reg, int bit) {
+    int info[4];
+    __cpuidex(info, leaf, 0);
+    return (info[reg] >> bit) & 1;
+}
+#endif
+
+bool CPUFeatures::hasSSE42() {
+#if JSON_X86_SIMD && (defined(__GNUC__) || defined(__clang__))
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+#elif JSON_X86_SIMD && defined(_MSC_VER)
+    static const bool supported = cpuidBit(1, 2, 20);
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool CPUFeatures::hasAVX2() {
+#if JSON_X86_SIMD && (defined(__GNUC__) || defined(__clang__))
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#elif JSON_X86_SIMD && defined(_MSC_VER)
+    // AVX2 also needs the OS to save YMM state (OSXSAVE + XCR0 bits 1,2)
+    static const bool supported = cpuidBit(7, 1, 5) && cpuidBit(1, 2, 27)
+                                  && (_xgetbv(0) & 0x6) == 0x6;
+    return supported;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,189 @@
+#include "../include/DocumentCache.h"
+#include "../include/JSONDocument.h"
+#include "../include/JSONSnapshot.h"
+#include "../include/ParallelParser.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* stampMagic = "json-cache";
+constexpr int stampVersion = 1;
+
+// FNV-1a: entry names must not change between builds
+uint64_t nameHash(std::string_view text) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::string hex(uint64_t value) {
+    char buf[17];
+    std::snprintf(buf, sizeof buf, "%016llx", static_cast<unsigned long long>(value));
+    return buf;
+}
+
+} // namespace
+
+DocumentCache::DocumentCache() {
+    const char* env = std::getenv("JSON_CACHE_DIR");
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (env && *env)
+        dir = env;
+    else if (xdg && *xdg)
+        dir = fs::path(xdg) / "json_parser";
+    else if (home && *home)
+        dir = fs::path(home) / ".cache" / "json_parser";
+    else
+        dir = fs::temp_directory_path() / "json_parser_cache";
+}
+
+DocumentCache::DocumentCache(fs::path directory) : dir(std::move(directory)) {}
+
+std::shared_ptr<const MappedFile> DocumentCache::map(const std::string& path, ThreadPool* pool) {
+    // Entries are only trusted in, and written to, a private directory
+    if (!privateDirectory())
+        return FileUtils::mapFile(path);
+
+    fs::path source = fs::absolute(path);
+    std::string name = hex(nameHash(source.string()));
+    fs::path entryPath = dir / (name + ".snap");
+    fs::path stampPath = dir / (name + ".stamp");
+
+    // An unreadable source gets the usual error from mapFile
+    std::error_code ec;
+    uint64_t size = fs::file_size(source, ec);
+    if (ec)
+        return FileUtils::mapFile(path);
+    auto modified = fs::last_write_time(source, ec);
+    if (ec)
+        return FileUtils::mapFile(path);
+    int64_t mtime = modified.time_since_epoch().count();
+
+    // ---- Lookup ----
+    Stamp stamp;
+    bool stamped = readStamp(stampPath, stamp) && stamp.size == size;
+    std::shared_ptr<const MappedFile> file;
+    uint64_t hash = 0;
+
+    if (stamped && stamp.mtime != mtime) {
+        file = FileUtils::mapFile(path);
+        hash = contentHash(*file);
+        stamped = hash == stamp.hash;
+    }
+
+    if (stamped) {
+        try {
+            auto entry = FileUtils::mapFile(entryPath.string());
+            if (entry->size() == stamp.entrySize) {
+                JSONSnapshot::open(entry);   // header check: version, byte order, size
+                if (stamp.mtime != mtime) {
+                    stamp.mtime = mtime;
+                    try { writeStamp(stampPath, stamp); } catch (const std::exception&) {}
+                }
+                return entry;
+            }
+        } catch (const std::runtime_error&) {
+            // missing or unreadable entry: rebuild it
+        }
+    }
+
+    // ---- Miss: parse, compile, store ----
+    if (!file) {
+        file = FileUtils::mapFile(path);
+        if (JSONSnapshot::isSnapshot(file->view()))
+            return file;   // never stamped, so this is the only way in
+        hash = contentHash(*file);
+    }
+
+    JSONDocument doc = pool ? ParallelParser::parse(file, *pool) : JSONDocument::parse(file);
+
+    // The file is valid JSON by now; a cache that can't be written
+    // (full disk, read-only directory) only costs the speedup
+    try {
+        std::string bytes = JSONSnapshot::compile(doc.root());
+        writeAtomically(entryPath, bytes);
+
+        stamp.size = size;
+        stamp.mtime = mtime;
+        stamp.hash = hash;
+        stamp.entrySize = bytes.size();
+        writeStamp(stampPath, stamp);
+
+        return FileUtils::mapFile(entryPath.string());
+    } catch (const std::exception&) {
+        return file;
+    }
+}
+
+// Creates the directory owner-only when missing. An existing one must
+// belong to this user and be writable by no one else: entries planted
+// by another user would otherwise be served as the file's contents.
+bool DocumentCache::privateDirectory() const {
+    std::error_code ec;
+    if (fs::create_directories(dir, ec))
+        fs::permissions(dir, fs::perms::owner_all, ec);
+    if (!fs::is_directory(dir, ec))
+        return false;
+
+#ifndef _WIN32
+    struct stat st;
+    if (::stat(dir.c_str(), &st) != 0 || st.st_uid != ::geteuid() || (st.st_mode & (S_IWGRP | S_IWOTH)))
+        return false;
+#endif
+    return true;
+}
+
+uint64_t DocumentCache::contentHash(const MappedFile& file) {
+    return std::hash<std::string_view>()(file.view());
+}
+
+bool DocumentCache::readStamp(const fs::path& path, Stamp& stamp) {
+    std::ifstream in(path);
+    std::string magic;
+    int version = 0;
+    return in >> magic >> version >> stamp.size >> stamp.mtime >> stamp.hash >> stamp.entrySize
+        && magic == stampMagic && version == stampVersion;
+}
+
+void DocumentCache::writeStamp(const fs::path& path, const Stamp& stamp) {
+    writeAtomically(path, std::string(stampMagic) + " " + std::to_string(stampVersion) + "\n"
+        + std::to_string(stamp.size) + " " + std::to_string(stamp.mtime) + " "
+        + std::to_string(stamp.hash) + " " + std::to_string(stamp.entrySize) + "\n");
+}
+
+void DocumentCache::writeAtomically(const fs::path& target, const std::string& bytes) {
+    fs::path temp = target;
+    temp += ".tmp" + hex(std::random_device()());
+
+    std::ofstream out(temp, std::ios::binary);
+    if (!out.is_open())
+        throw std::runtime_error("Cannot write cache entry: " + temp.string());
+    out.write(bytes.data(), bytes.size());
+    out.close();
+
+    std::error_code ec;
+    if (out.fail())
+        ec = std::make_error_code(std::errc::io_error);
+    else
+        fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        throw std::runtime_error("Cannot write cache entry: " + target.string());
+    }
+}
@@ -1,16 +1,54 @@
 #include "../include/FileUtils.h"
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 std::string FileUtils::readFile(const std::string& path) {
-    std::ifstream file(path);
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open())
         throw std::runtime_error("Cannot open file: " + path);
 
-    std::stringstream buffer;  //create a stringstream object to hold the file contents
-    buffer << file.rdbuf();    //dumps the entire file content into the stringstream
-    return buffer.str();       //return the content as a string
+    // Read straight into a string of the right size (one copy, no stringstream)
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+
+    // Pipes and FIFOs have no size: read until end of input
+    if (size < 0) {
+        file.clear();
+        std::string content;
+        char buffer[1 << 16];
+        while (file.read(buffer, sizeof buffer) || file.gcount() > 0)
+            content.append(buffer, size_t(file.gcount()));
+        if (file.bad())
+            throw std::runtime_error("Cannot read file: " + path);
+        return content;
+    }
+
+    file.seekg(0, std::ios::beg);
+    std::string content(static_cast<size_t>(size), '\0');
+    if (size > 0 && !file.read(&content[0], size))
+        throw std::runtime_error("Cannot read file: " + path);
+    return content;
+}
+
+std::shared_ptr<const MappedFile> FileUtils::mapFile(const std::string& path) {
+    return std::make_shared<const MappedFile>(path);
 }
 
 void FileUtils::writeFile(const std::string& path, const std::string& content) {
@@ -20,3 +58,234 @@ void FileUtils::writeFile(const std::string& path, const std::string& content) {
 
     file << content;
 }
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Copies `count` bytes (or everything left, for npos) in 1 MB chunks
+bool copyBytes(std::istream& in, std::ostream& out, size_t count) {
+    bool toEnd = count == std::string::npos;
+    std::vector<char> buffer(1 << 20);
+    while (count > 0 && in) {
+        in.read(buffer.data(), std::streamsize(std::min(count, buffer.size())));
+        std::streamsize got = in.gcount();
+        if (got <= 0)
+            break;
+        out.write(buffer.data(), got);
+        count -= size_t(got);
+    }
+    return toEnd ? !in.bad() : count == 0;
+}
+
+} // namespace
+
+void FileUtils::replaceRange(const std::string& path, size_t begin, size_t end, std::string_view replacement) {
+    // Same length: overwrite just those bytes
+    if (replacement.size() == end - begin) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot write to file: " + path);
+        file.seekp(std::streamoff(begin));
+        file.write(replacement.data(), std::streamsize(replacement.size()));
+        if (!file)
+            throw std::runtime_error("Cannot write to file: " + path);
+        return;
+    }
+
+    // The tail moves: stream prefix + replacement + tail into a new copy
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        throw std::runtime_error("Cannot open file: " + path);
+    writeReplacing(path, [&](std::ostream& out) {
+        bool ok = copyBytes(in, out, begin);
+        out.write(replacement.data(), std::streamsize(replacement.size()));
+        in.clear();
+        in.seekg(std::streamoff(end));
+        if (!(ok && copyBytes(in, out, std::string::npos)))
+            throw std::runtime_error("Cannot read file: " + path);
+    });
+}
+
+void FileUtils::writeReplacing(const std::string& path, const std::function<void(std::ostream&)>& produce) {
+    // A symlink is resolved first so the rename replaces its target,
+    // not the link; a file that doesn't exist yet is created as given
+    std::error_code ec;
+    bool exists = fs::exists(path, ec);
+    fs::path target = exists ? fs::canonical(path, ec) : fs::path(path);
+    if (ec)
+        throw std::runtime_error("Cannot write to file: " + path);
+    fs::perms mode = exists ? fs::status(target, ec).permissions() : fs::perms::unknown;
+
+    fs::path temp = target;
+    temp += ".tmp" + std::to_string(std::random_device()());
+    try {
+        std::ofstream out(temp, std::ios::binary);
+        if (!out.is_open())
+            throw std::runtime_error("Cannot write to file: " + temp.string());
+        produce(out);
+        out.close();
+        if (out.fail())
+            throw std::runtime_error("Cannot write to file: " + path);
+    } catch (...) {
+        fs::remove(temp, ec);
+        throw;
+    }
+
+    // A file with other hard links keeps its inode: the new content is
+    // copied back over it instead of renamed into place
+    bool linked = exists && fs::hard_link_count(target, ec) > 1 && !ec;
+    if (linked) {
+        std::ifstream in(temp, std::ios::binary);
+        std::ofstream out(target, std::ios::binary | std::ios::trunc);
+        bool ok = in.is_open() && out.is_open() && copyBytes(in, out, std::string::npos);
+        out.close();
+        fs::remove(temp, ec);
+        if (!ok || out.fail())
+            throw std::runtime_error("Cannot write to file: " + path);
+        return;
+    }
+
+    if (exists)
+        fs::permissions(temp, mode, ec);
+    if (!ec)
+        fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        throw std::runtime_error("Cannot write to file: " + path);
+    }
+}
+
+// ====================================================
+// MappedFile
+// ====================================================
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot read file: " + path);
+    }
+    length = static_cast<size_t>(size.QuadPart);
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t page = info.dwPageSize;
+    size_t slack = length % page ? page - length % page : 0;
+
+    // The mapping is zero-filled up to the end of its last page
+    if (length > 0 && slack >= padding) {
+        HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (view) {
+            mapping = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(view);
+        }
+    }
+    CloseHandle(file);
+
+    if (mapping) {
+        ptr = static_cast<const char*>(mapping);
+        mappedLength = length;
+        return;
+    }
+
+    std::string content = FileUtils::readFile(path);
+    length = content.size();
+    heap.reset(new char[length + padding]);
+    std::memcpy(heap.get(), content.data(), length);
+    std::memset(heap.get() + length, 0, padding);
+    ptr = heap.get();
+}
+
+MappedFile::~MappedFile() {
+    if (mapping)
+        UnmapViewOfFile(mapping);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read file: " + path);
+    }
+    // Pipes, FIFOs and character devices report no size and cannot be
+    // mapped: read them until end of input into the padded buffer
+    if (!S_ISREG(st.st_mode)) {
+        size_t capacity = 1 << 16;
+        heap.reset(new char[capacity + padding]);
+        for (;;) {
+            if (length == capacity) {
+                std::unique_ptr<char[]> grown(new char[capacity * 2 + padding]);
+                std::memcpy(grown.get(), heap.get(), length);
+                heap = std::move(grown);
+                capacity *= 2;
+            }
+            ssize_t n = ::read(fd, heap.get() + length, capacity - length);
+            if (n < 0) {
+                ::close(fd);
+                throw std::runtime_error("Cannot read file: " + path);
+            }
+            if (n == 0)
+                break;
+            length += static_cast<size_t>(n);
+        }
+        std::memset(heap.get() + length, 0, padding);
+        ptr = heap.get();
+        ::close(fd);
+        return;
+    }
+    length = static_cast<size_t>(st.st_size);
+
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t slack = length % page ? page - length % page : 0;
+
+    // The kernel zero-fills the mapping up to the end of its last page,
+    // so that tail is our padding when it is large enough
+    if (length > 0 && slack >= padding) {
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            mapping = p;
+            mappedLength = length;
+            ptr = static_cast<const char*>(p);
+#ifdef MADV_SEQUENTIAL
+            ::madvise(p, length, MADV_SEQUENTIAL);
+#endif
+        }
+    }
+
+    if (!mapping) {
+        heap.reset(new char[length + padding]);
+        std::memset(heap.get() + length, 0, padding);
+        size_t done = 0;
+        while (done < length) {
+            ssize_t n = ::read(fd, heap.get() + done, length - done);
+            if (n <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Cannot read file: " + path);
+            }
+            done += static_cast<size_t>(n);
+        }
+        ptr = heap.get();
+    }
+
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (mapping)
+        ::munmap(mapping, mappedLength);
+}
+
+#endif
@@ -0,0 +1,526 @@
+#include "../include/HTTPServer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// ====================================================
+// Platform layer
+// ====================================================
+#ifdef _WIN32
+
+using Socket = SOCKET;
+using PollFD = WSAPOLLFD;
+constexpr int sendFlags = 0;
+
+void startSockets() {
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!started)
+        throw std::runtime_error("Cannot initialize Winsock");
+}
+
+int pollSockets(PollFD* fds, size_t count, int timeoutMs) { return WSAPoll(fds, ULONG(count), timeoutMs); }
+void closeSocket(Socket s) { closesocket(s); }
+bool interrupted() { return false; }
+bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+std::string lastError() { return "error " + std::to_string(WSAGetLastError()); }
+
+void setNonBlocking(Socket s) {
+    u_long on = 1;
+    ioctlsocket(s, FIONBIO, &on);
+}
+
+#else
+
+using Socket = int;
+using PollFD = pollfd;
+#ifdef MSG_NOSIGNAL
+constexpr int sendFlags = MSG_NOSIGNAL;   // a vanished client must not raise SIGPIPE
+#else
+constexpr int sendFlags = 0;
+#endif
+
+void startSockets() {}
+int pollSockets(PollFD* fds, size_t count, int timeoutMs) { return ::poll(fds, nfds_t(count), timeoutMs); }
+void closeSocket(Socket s) { ::close(s); }
+bool interrupted() { return errno == EINTR; }
+bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+std::string lastError() { return std::strerror(errno); }
+
+void setNonBlocking(Socket s) {
+    ::fcntl(s, F_SETFL, ::fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+}
+
+#endif
+
+Socket toSocket(intptr_t s) { return static_cast<Socket>(s); }
+
+void configureClient(Socket s) {
+    setNonBlocking(s);
+    int on = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof on);
+#ifdef SO_NOSIGPIPE
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<const char*>(&on), sizeof on);
+#endif
+}
+
+// Writes everything, waiting for the socket to drain when the send
+// buffer is full; false when the client is gone or stalls too long
+bool sendAll(Socket s, std::string_view data) {
+    while (!data.empty()) {
+        int chunk = int(std::min<size_t>(data.size(), 1 << 30));
+        auto sent = ::send(s, data.data(), chunk, sendFlags);
+        if (sent > 0) {
+            data.remove_prefix(size_t(sent));
+            continue;
+        }
+        if (sent < 0 && interrupted())
+            continue;
+        if (sent < 0 && wouldBlock()) {
+            PollFD fd{};
+            fd.fd = s;
+            fd.events = POLLOUT;
+            int timeoutMs = int(std::chrono::milliseconds(HTTPServer::idleTimeout).count());
+            if (pollSockets(&fd, 1, timeoutMs) > 0)
+                continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+// Bound, listening, non-blocking socket; `port` 0 picks a free port
+// and is updated to the one bound
+Socket listenOn(const std::string& host, uint16_t& port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addrs = nullptr;
+    std::string where = host + ":" + std::to_string(port);
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), std::to_string(port).c_str(), &hints, &addrs) != 0)
+        throw std::runtime_error("Cannot resolve listen address " + where);
+
+    Socket s = Socket(-1);
+    std::string error;
+    for (addrinfo* a = addrs; a && s == Socket(-1); a = a->ai_next) {
+        s = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (s == Socket(-1))
+            continue;
+#ifndef _WIN32
+        int on = 1;   // restart without waiting out TIME_WAIT
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof on);
+#endif
+        if (::bind(s, a->ai_addr, int(a->ai_addrlen)) != 0 || ::listen(s, SOMAXCONN) != 0) {
+            error = lastError();
+            closeSocket(s);
+            s = Socket(-1);
+        }
+    }
+    freeaddrinfo(addrs);
+    if (s == Socket(-1))
+        throw std::runtime_error("Cannot listen on " + where + (error.empty() ? "" : ": " + error));
+
+    setNonBlocking(s);
+
+    sockaddr_storage bound{};
+    socklen_t size = sizeof bound;
+    getsockname(s, reinterpret_cast<sockaddr*>(&bound), &size);
+    port = bound.ss_family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port)
+                                       : ntohs(reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+    return s;
+}
+
+// Connected loopback pair (reader, writer); stands in for a pipe,
+// which Windows can't poll
+std::pair<Socket, Socket> loopbackPair() {
+    uint16_t port = 0;
+    Socket server = listenOn("127.0.0.1", port);
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    Socket writer = ::socket(AF_INET, SOCK_STREAM, 0);
+    bool connected = writer != Socket(-1)
+        && ::connect(writer, reinterpret_cast<sockaddr*>(&addr), sizeof addr) == 0;
+
+    Socket reader = Socket(-1);
+    if (connected) {
+        PollFD fd{};
+        fd.fd = server;
+        fd.events = POLLIN;
+        if (pollSockets(&fd, 1, 5000) > 0)
+            reader = ::accept(server, nullptr, nullptr);
+    }
+    std::string error = lastError();
+    closeSocket(server);
+
+    if (reader == Socket(-1)) {
+        if (writer != Socket(-1))
+            closeSocket(writer);
+        throw std::runtime_error("Cannot create wake-up socket: " + error);
+    }
+    configureClient(reader);
+    configureClient(writer);
+    return {reader, writer};
+}
+
+std::string lowercase(std::string_view s) {
+    std::string out(s);
+    for (char& c : out)
+        c = char(std::tolower(static_cast<unsigned char>(c)));
+    return out;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// Comma-separated header value contains the token (case-insensitive)
+bool hasToken(std::string_view value, std::string_view token) {
+    std::string lower = lowercase(value);
+    std::string_view rest = lower;
+    while (!rest.empty()) {
+        size_t comma = rest.find(',');
+        if (trim(rest.substr(0, comma)) == token)
+            return true;
+        if (comma == std::string_view::npos)
+            break;
+        rest.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+const char* reason(int status) {
+    switch (status) {
+        case 100: return "Continue";
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 505: return "HTTP Version Not Supported";
+        default:  return "Unknown";
+    }
+}
+
+} // namespace
+
+// ====================================================
+// Request parsing / response formatting
+// ====================================================
+std::string_view HTTPRequest::header(std::string_view name) const {
+    for (const auto& h : headers) {
+        if (h.first == name)
+            return h.second;
+    }
+    return {};
+}
+
+size_t HTTPServer::parseRequest(std::string_view buffer, HTTPRequest& request) {
+    size_t headerEnd = buffer.find("\r\n\r\n");
+    if (headerEnd == std::string_view::npos) {
+        if (buffer.size() > maxHeaderBytes)
+            throw HTTPError(431, "Request headers too large");
+        // A blank line without CR would otherwise wait out the idle timeout
+        if (buffer.find("\n\n") != std::string_view::npos)
+            throw HTTPError(400, "Header lines must end in CRLF");
+        return 0;
+    }
+    if (headerEnd > maxHeaderBytes)
+        throw HTTPError(431, "Request headers too large");
+
+    request = HTTPRequest();
+    std::string_view head = buffer.substr(0, headerEnd);
+
+    // ---- Request line: METHOD SP target SP version ----
+    size_t lineEnd = std::min(head.find("\r\n"), head.size());
+    std::string_view line = head.substr(0, lineEnd);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string_view::npos ? sp1 : line.find(' ', sp1 + 1);
+    if (sp2 == std::string_view::npos || sp1 == 0 || sp2 == sp1 + 1)
+        throw HTTPError(400, "Malformed request line");
+
+    request.method = std::string(line.substr(0, sp1));
+    std::string_view target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    std::string_view version = line.substr(sp2 + 1);
+
+    if (version == "HTTP/1.1")
+        request.keepAlive = true;
+    else if (version == "HTTP/1.0")
+        request.keepAlive = false;
+    else
+        throw HTTPError(505, "Unsupported HTTP version");
+
+    size_t question = target.find('?');
+    request.path = std::string(target.substr(0, question));
+    if (question != std::string_view::npos)
+        request.query = std::string(target.substr(question + 1));
+
+    // ---- Header fields ----
+    std::string_view rest = lineEnd < head.size() ? head.substr(lineEnd + 2) : std::string_view();
+    while (!rest.empty()) {
+        size_t end = std::min(rest.find("\r\n"), rest.size());
+        std::string_view field = rest.substr(0, end);
+        rest.remove_prefix(std::min(end + 2, rest.size()));
+
+        size_t colon = field.find(':');
+        if (colon == std::string_view::npos || colon == 0)
+            throw HTTPError(400, "Malformed header field");
+        request.headers.emplace_back(lowercase(field.substr(0, colon)),
+                                     std::string(trim(field.substr(colon + 1))));
+    }
+
+    std::string_view connection = request.header("connection");
+    if (hasToken(connection, "close"))
+        request.keepAlive = false;
+    else if (hasToken(connection, "keep-alive"))
+        request.keepAlive = true;
+
+    // ---- Body ----
+    if (!request.header("transfer-encoding").empty())
+        throw HTTPError(411, "Chunked request bodies are not supported; send Content-Length");
+
+    size_t length = 0;
+    std::string_view lengthField = request.header("content-length");
+    if (!lengthField.empty()) {
+        for (char c : lengthField) {
+            if (c < '0' || c > '9')
+                throw HTTPError(400, "Invalid Content-Length");
+            length = length * 10 + size_t(c - '0');
+            if (length > maxBodyBytes)
+                throw HTTPError(413, "Request body too large");
+        }
+    }
+
+    size_t bodyStart = headerEnd + 4;
+    if (buffer.size() - bodyStart < length)
+        return 0;   // headers are filled in, the body is still arriving
+
+    request.body = std::string(buffer.substr(bodyStart, length));
+    return bodyStart + length;
+}
+
+std::string HTTPServer::formatResponse(const HTTPResponse& response, bool keepAlive) {
+    std::string out;
+    out.reserve(response.body.size() + 128);
+    out += "HTTP/1.1 ";
+    out += std::to_string(response.status);
+    out += ' ';
+    out += reason(response.status);
+    out += "\r\nContent-Type: ";
+    out += response.contentType;
+    out += "\r\nContent-Length: ";
+    out += std::to_string(response.body.size());
+    out += keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+    out += response.body;
+    return out;
+}
+
+// ====================================================
+// Server
+// ====================================================
+struct HTTPServer::Connection {
+    Socket socket;
+    std::string buffer;                     // received, not yet answered
+    bool continued = false;                 // "100 Continue" sent for the pending request
+    std::chrono::steady_clock::time_point lastActive = std::chrono::steady_clock::now();
+
+    explicit Connection(Socket s) : socket(s) {}
+    ~Connection() { closeSocket(socket); }
+};
+
+HTTPServer::HTTPServer(Handler handler, ThreadPool& pool) : handler(std::move(handler)), pool(pool) {
+    startSockets();
+    auto [reader, writer] = loopbackPair();
+    wakeRead = intptr_t(reader);
+    wakeWrite = intptr_t(writer);
+}
+
+HTTPServer::~HTTPServer() {
+    // Workers still answering hold a pointer to this server
+    while (inFlight > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    for (intptr_t s : {listener, wakeRead, wakeWrite}) {
+        if (s != -1)
+            closeSocket(toSocket(s));
+    }
+}
+
+uint16_t HTTPServer::listen(const std::string& host, uint16_t port) {
+    Socket s = listenOn(host, port);
+    if (listener != -1)
+        closeSocket(toSocket(listener));
+    listener = intptr_t(s);
+    return port;
+}
+
+void HTTPServer::run() {
+    if (listener == -1)
+        throw std::runtime_error("HTTPServer::run() before listen()");
+
+    std::vector<std::unique_ptr<Connection>> idle;
+    std::vector<PollFD> fds;
+
+    while (!stopping) {
+        {
+            std::lock_guard<std::mutex> lock(returnedMutex);
+            for (auto& c : returned)
+                idle.push_back(std::move(c));
+            returned.clear();
+        }
+
+        fds.assign(idle.size() + 2, PollFD{});
+        fds[0].fd = toSocket(listener);
+        fds[1].fd = toSocket(wakeRead);
+        fds[0].events = fds[1].events = POLLIN;
+        for (size_t i = 0; i < idle.size(); i++) {
+            fds[i + 2].fd = idle[i]->socket;
+            fds[i + 2].events = POLLIN;
+        }
+
+        // The timeout only paces the idle sweep below
+        if (pollSockets(fds.data(), fds.size(), 1000) < 0) {
+            if (interrupted())
+                continue;
+            throw std::runtime_error("poll failed: " + lastError());
+        }
+
+        if (fds[1].revents) {
+            char drain[256];
+            while (::recv(toSocket(wakeRead), drain, sizeof drain, 0) > 0) {}
+        }
+
+        // Readable connections go to the pool, stale ones are closed
+        auto now = std::chrono::steady_clock::now();
+        size_t kept = 0;
+        for (size_t i = 0; i < idle.size(); i++) {
+            if (fds[i + 2].revents) {
+                Connection* c = idle[i].release();
+                inFlight++;
+                pool.submit([this, c] {
+                    serve(std::unique_ptr<Connection>(c));
+                    inFlight--;
+                });
+            } else if (now - idle[i]->lastActive < idleTimeout) {
+                idle[kept++] = std::move(idle[i]);
+            }
+        }
+        idle.resize(kept);
+
+        if (fds[0].revents) {
+            for (;;) {
+                Socket s = ::accept(toSocket(listener), nullptr, nullptr);
+                if (s == Socket(-1))
+                    break;
+                configureClient(s);
+                idle.push_back(std::make_unique<Connection>(s));
+            }
+        }
+    }
+}
+
+void HTTPServer::stop() {
+    stopping = true;
+    wake();
+}
+
+void HTTPServer::wake() {
+    char byte = 1;
+    ::send(toSocket(wakeWrite), &byte, 1, sendFlags);
+}
+
+void HTTPServer::giveBack(std::unique_ptr<Connection> connection) {
+    connection->lastActive = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(returnedMutex);
+        returned.push_back(std::move(connection));
+    }
+    wake();
+}
+
+// Runs on a pool thread: reads what the client has sent, answering
+// each request as soon as it is complete, then hands the connection
+// back (or drops it). Parsing between reads keeps the buffer to one
+// request plus one chunk, so the header and body limits hold while a
+// client is still sending.
+void HTTPServer::serve(std::unique_ptr<Connection> c) {
+    bool peerClosed = false;
+    char chunk[64 * 1024];
+    try {
+        for (bool reading = true; reading; ) {
+            auto got = ::recv(c->socket, chunk, int(sizeof chunk), 0);
+            if (got > 0) {
+                c->buffer.append(chunk, size_t(got));
+            } else if (got < 0 && interrupted()) {
+                continue;
+            } else {
+                peerClosed = got == 0 || !wouldBlock();
+                reading = false;
+            }
+
+            for (;;) {
+                HTTPRequest request;
+                size_t used = parseRequest(c->buffer, request);
+                if (used == 0) {
+                    // Headers are in but the body is not: a client sending
+                    // "Expect: 100-continue" is waiting for the go-ahead
+                    if (!request.method.empty() && !c->continued
+                        && lowercase(request.header("expect")) == "100-continue") {
+                        c->continued = true;
+                        if (!sendAll(c->socket, "HTTP/1.1 100 Continue\r\n\r\n"))
+                            return;
+                    }
+                    break;
+                }
+                c->buffer.erase(0, used);
+                c->continued = false;
+
+                HTTPResponse response;
+                try {
+                    response = handler(request);
+                } catch (const std::exception& e) {
+                    response = HTTPResponse{500, "text/plain", e.what()};
+                }
+
+                bool keepAlive = request.keepAlive && !peerClosed && !stopping;
+                if (!sendAll(c->socket, formatResponse(response, keepAlive)) || !keepAlive)
+                    return;
+            }
+        }
+    } catch (const HTTPError& e) {
+        sendAll(c->socket, formatResponse(HTTPResponse{e.status, "text/plain", e.what()}, false));
+        return;
+    }
+
+    if (!peerClosed)
+        giveBack(std::move(c));
+}
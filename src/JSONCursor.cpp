@@ -0,0 +1,291 @@
+#include "../include/JSONCursor.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Bytes that matter while skipping over a container
+struct SkipTable {
+    bool special[256] = {};
+    SkipTable() {
+        for (unsigned char c : {'"', '{', '}', '[', ']'})
+            special[c] = true;
+    }
+};
+
+const SkipTable skipTable;
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+size_t JSONCursor::skipWhitespace(size_t i) const {
+    while (i < text.size() && isWhitespace(text[i]))
+        i++;
+    return i;
+}
+
+size_t JSONCursor::skipString(size_t quote) const {
+    const char* data = text.data();
+    size_t i = quote + 1;
+
+    while (i < text.size()) {
+        const void* hit = std::memchr(data + i, '"', text.size() - i);
+        if (!hit)
+            break;
+
+        size_t close = size_t(static_cast<const char*>(hit) - data);
+
+        // The quote is escaped when an odd number of backslashes precede it
+        size_t backslashes = 0;
+        while (close - backslashes > quote + 1 && data[close - backslashes - 1] == '\\')
+            backslashes++;
+
+        if (backslashes % 2 == 0)
+            return close + 1;
+        i = close + 1;
+    }
+
+    fail("Unterminated string literal", quote);
+}
+
+size_t JSONCursor::skipContainer(size_t open) const {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t n = text.size();
+    size_t i = open;
+
+    // Closer expected for each container still open, so `[1, 2}` is
+    // rejected instead of being taken as one value
+    std::string closers;
+
+    while (true) {
+        while (i < n && !skipTable.special[data[i]])
+            i++;
+        if (i >= n)
+            break;
+
+        char c = char(data[i]);
+        if (c == '"') {
+            i = skipString(i);
+            continue;
+        }
+
+        if (c == '{' || c == '[') {
+            closers.push_back(c == '{' ? '}' : ']');
+        } else {
+            if (c != closers.back())
+                fail(std::string("Expected '") + closers.back() + "' but found '" + c + "'", i);
+            closers.pop_back();
+            if (closers.empty())
+                return i + 1;
+        }
+        i++;
+    }
+
+    fail(text[open] == '{' ? "Unterminated object" : "Unterminated array", open);
+}
+
+size_t JSONCursor::skipScalar(size_t i) const {
+    size_t start = i;
+    while (i < text.size()) {
+        char c = text[i];
+        if (c == ',' || c == ']' || c == '}' || c == ':' || isWhitespace(c))
+            break;
+        i++;
+    }
+
+    if (i == start) {
+        if (i >= text.size())
+            fail("Unexpected end of input, expected a value", i);
+        fail("Unexpected character '" + std::string(1, text[i]) + "', expected a value", i);
+    }
+    return i;
+}
+
+size_t JSONCursor::skipValue(size_t i) const {
+    if (i < text.size()) {
+        char c = text[i];
+        if (c == '"')
+            return skipString(i);
+        if (c == '{' || c == '[')
+            return skipContainer(i);
+    }
+    return skipScalar(i);
+}
+
+bool JSONCursor::keyEquals(size_t quote, size_t end, const std::string& key) const {
+    std::string_view raw = text.substr(quote + 1, end - quote - 2);
+
+    if (raw.find('\\') == std::string_view::npos)
+        return raw == key;
+
+    // Rare: escaped key, decode it with the tokenizer before comparing
+    Tokenizer tokenizer(text.substr(quote, end - quote));
+    return tokenizer.nextToken().text() == key;
+}
+
+// Returns the offset of the member's value, or npos when the key is absent
+size_t JSONCursor::findMember(size_t open, const std::string& key) const {
+    size_t i = skipWhitespace(open + 1);
+    if (i < text.size() && text[i] == '}')
+        return std::string_view::npos;
+
+    while (true) {
+        if (i >= text.size() || text[i] != '"')
+            fail("Expected string key in object", i);
+
+        size_t keyEnd = skipString(i);
+        bool match = keyEquals(i, keyEnd, key);
+
+        i = skipWhitespace(keyEnd);
+        if (i >= text.size() || text[i] != ':')
+            fail("Expected ':' after key", i);
+        i = skipWhitespace(i + 1);
+
+        // First occurrence wins, as in the DOM builders
+        if (match)
+            return i;
+
+        i = skipWhitespace(skipValue(i));
+        if (i < text.size() && text[i] == ',') {
+            i = skipWhitespace(i + 1);
+            continue;
+        }
+        if (i < text.size() && text[i] == '}')
+            return std::string_view::npos;
+
+        fail("Expected ',' or '}' in object", i);
+    }
+}
+
+// Returns the offset of element `index`, or npos when it is out of bounds
+size_t JSONCursor::findElement(size_t open, int index) const {
+    size_t i = skipWhitespace(open + 1);
+    if (index < 0 || (i < text.size() && text[i] == ']'))
+        return std::string_view::npos;
+
+    for (int count = 0; ; count++) {
+        if (count == index)
+            return i;
+
+        i = skipWhitespace(skipValue(i));
+        if (i < text.size() && text[i] == ',') {
+            i = skipWhitespace(i + 1);
+            continue;
+        }
+        if (i < text.size() && text[i] == ']')
+            return std::string_view::npos;
+
+        fail("Expected ',' or ']' in array", i);
+    }
+}
+
+ValueSpan JSONCursor::locate(const std::vector<PathElement>& path) const {
+    size_t i = skipWhitespace(0);
+
+    for (const auto& p : path) {
+        if (p.isIndex) {
+            if (i >= text.size() || text[i] != '[')
+                throw std::runtime_error("Expected array in path");
+
+            i = findElement(i, p.index);
+            if (i == std::string_view::npos)
+                throw std::runtime_error("Array index out of bounds");
+        }
+        else {
+            if (i >= text.size() || text[i] != '{')
+                throw std::runtime_error("Expected object in path");
+
+            i = findMember(i, p.key);
+            if (i == std::string_view::npos)
+                throw std::runtime_error("Key not found: " + p.key);
+        }
+    }
+
+    return spanAt(i, skipValue(i));
+}
+
+ValueSpan JSONCursor::locateChecked(const std::vector<PathElement>& path) const {
+    Tokenizer tokenizer(text);
+    tokenizer.enableStructuralIndex();
+    JSONHandler ignoreEvents;
+    Parser(tokenizer).parse(ignoreEvents);
+
+    return locate(path);
+}
+
+JSONValue JSONCursor::get(const std::vector<PathElement>& path) const {
+    ValueSpan span = locate(path);
+
+    Tokenizer tokenizer(text.substr(0, span.end));
+    tokenizer.seek(span.begin, span.line, span.lineStart);
+    return Parser(tokenizer).parse();
+}
+
+bool JSONCursor::rootElements(std::vector<ValueSpan>& elements) const {
+    elements.clear();
+
+    size_t i = skipWhitespace(0);
+    if (i >= text.size() || text[i] != '[')
+        return false;
+
+    // Line numbers are carried forward from element to element, so the
+    // whole walk counts every newline once
+    ValueSpan span;
+    size_t counted = 0;
+
+    try {
+        i = skipWhitespace(i + 1);
+        if (i < text.size() && text[i] == ']')
+            return skipWhitespace(i + 1) == text.size();
+
+        while (true) {
+            const char* data = text.data();
+            for (const char* nl = static_cast<const char*>(std::memchr(data + counted, '\n', i - counted));
+                 nl; nl = static_cast<const char*>(std::memchr(nl + 1, '\n', data + i - nl - 1))) {
+                span.line++;
+                span.lineStart = size_t(nl - data) + 1;
+            }
+            counted = i;
+
+            span.begin = i;
+            span.end = skipValue(i);
+            elements.push_back(span);
+
+            i = skipWhitespace(span.end);
+            if (i < text.size() && text[i] == ',') {
+                i = skipWhitespace(i + 1);
+                continue;
+            }
+            if (i < text.size() && text[i] == ']')
+                return skipWhitespace(i + 1) == text.size();
+            return false;
+        }
+    } catch (const JSONParseError&) {
+        return false;
+    }
+}
+
+// Line information is only needed once per lookup (or per error), so it
+// is recovered here instead of being tracked while skipping
+ValueSpan JSONCursor::spanAt(size_t begin, size_t end) const {
+    ValueSpan span;
+    span.begin = begin;
+    span.end = end;
+
+    const char* data = text.data();
+    for (const char* nl = static_cast<const char*>(std::memchr(data, '\n', begin));
+         nl; nl = static_cast<const char*>(std::memchr(nl + 1, '\n', data + begin - nl - 1))) {
+        span.line++;
+        span.lineStart = size_t(nl - data) + 1;
+    }
+    return span;
+}
+
+void JSONCursor::fail(const std::string& msg, size_t at) const {
+    at = std::min(at, text.size());
+    ValueSpan where = spanAt(at, at);
+    throw JSONParseError(msg, where.line, int(at - where.lineStart) + 1);
+}
@@ -0,0 +1,342 @@
+#include "../include/JSONDocument.h"
+#include <algorithm>
+#include <limits>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// ====================================================
+// DocValue accessors
+// ====================================================
+std::string_view DocValue::asString() const {
+    if (!isString()) throw std::runtime_error("Not a JSON string");
+    return std::string_view(chars, length);
+}
+
+double DocValue::asNumber() const {
+    if (!isNumber()) throw std::runtime_error("Not a JSON number");
+    return isInteger() ? double(integer) : number;
+}
+
+int64_t DocValue::asInteger() const {
+    if (!isInteger()) throw std::runtime_error("Not a JSON integer");
+    return integer;
+}
+
+bool DocValue::asBool() const {
+    if (!isBool()) throw std::runtime_error("Not a JSON boolean");
+    return boolean;
+}
+
+const DocValue& DocValue::operator[](size_t index) const {
+    if (!isArray()) throw std::runtime_error("Not a JSON array");
+    if (index >= length) throw std::runtime_error("Array index out of bounds");
+    return items[index];
+}
+
+const DocMember& DocValue::member(size_t index) const {
+    if (!isObject()) throw std::runtime_error("Not a JSON object");
+    if (index >= length) throw std::runtime_error("Object member index out of bounds");
+    return members[index];
+}
+
+const DocValue* DocValue::find(std::string_view key) const {
+    if (!isObject()) throw std::runtime_error("Not a JSON object");
+    for (uint32_t i = 0; i < length; i++) {
+        if (members[i].key == key)
+            return &members[i].value;
+    }
+    return nullptr;
+}
+
+JSONValue DocValue::toValue() const {
+    KeyTable keys;
+    return toValue(keys);
+}
+
+namespace {
+
+// A scalar converted whole, or an empty container sized for the children
+JSONValue convertNode(const DocValue& v) {
+    switch (v.type) {
+        case DocValue::Type::Null:   return JSONValue(nullptr);
+        case DocValue::Type::Bool:   return JSONValue(v.boolean);
+        case DocValue::Type::Number: return JSONValue(v.number);
+        case DocValue::Type::Integer: return JSONValue(v.integer);
+        case DocValue::Type::String: return JSONValue(std::string(v.chars, v.length));
+        case DocValue::Type::Array: {
+            JSONArray arr;
+            arr.reserve(v.length);
+            return JSONValue(std::move(arr));
+        }
+        case DocValue::Type::Object: {
+            JSONObject obj;
+            obj.reserve(v.length);
+            return JSONValue(std::move(obj));
+        }
+    }
+    return JSONValue(nullptr);
+}
+
+} // namespace
+
+// Containers being filled wait on an explicit stack (no recursion per
+// level), each with its source node and the next child to convert
+JSONValue DocValue::toValue(KeyTable& keys) const {
+    struct Frame {
+        const DocValue* source;
+        JSONValue value;
+        uint32_t next;
+    };
+
+    JSONValue converted = convertNode(*this);
+    if (!isArray() && !isObject())
+        return converted;
+
+    std::vector<Frame> open;
+    open.push_back(Frame{this, std::move(converted), 0});
+    for (;;) {
+        Frame& top = open.back();
+        const DocValue* child = nullptr;
+        if (top.next < top.source->length) {
+            child = top.source->isArray() ? &top.source->items[top.next] : &top.source->members[top.next].value;
+            top.next++;
+            converted = convertNode(*child);
+            if ((child->isArray() || child->isObject()) && child->length > 0) {
+                open.push_back(Frame{child, std::move(converted), 0});
+                continue;
+            }
+        } else {
+            converted = std::move(top.value);
+            open.pop_back();
+            if (open.empty())
+                return converted;
+        }
+
+        // Attach the finished value to the innermost open container
+        Frame& parent = open.back();
+        auto node = std::make_shared<JSONValue>(std::move(converted));
+        if (parent.source->isArray())
+            parent.value.asArray().push_back(std::move(node));
+        else
+            parent.value.asObject().emplace(keys.intern(parent.source->members[parent.next - 1].key), std::move(node));
+    }
+}
+
+// ====================================================
+// DocumentBuilder — SAX handler that fills the arena
+//
+// Completed children of the open containers wait on scratch stacks
+// shared by all nesting levels; when a container closes, its children
+// are copied into one exactly-sized arena slice and popped.
+// ====================================================
+class DocumentBuilder : public JSONHandler {
+public:
+    explicit DocumentBuilder(JSONDocument& d) : doc(d) {}
+
+    void startObject() override { open.push_back(Level{true, std::string_view()}); }
+
+    void key(std::string_view name) override {
+        open.back().pendingKey = std::string_view(storeText(name), name.size());
+    }
+
+    void endObject(size_t memberCount) override {
+        memberCount = dropDuplicates(memberCount);
+        DocMember* members = doc.arena.allocateArray<DocMember>(memberCount);
+        std::copy(memberStack.end() - memberCount, memberStack.end(), members);
+        memberStack.resize(memberStack.size() - memberCount);
+        open.pop_back();
+
+        DocValue v;
+        v.type = DocValue::Type::Object;
+        v.length = checkedLength(memberCount);
+        v.members = members;
+        addValue(v);
+    }
+
+    void startArray() override { open.push_back(Level{false, std::string_view()}); }
+
+    void endArray(size_t elementCount) override {
+        DocValue* items = doc.arena.allocateArray<DocValue>(elementCount);
+        std::copy(valueStack.end() - elementCount, valueStack.end(), items);
+        valueStack.resize(valueStack.size() - elementCount);
+        open.pop_back();
+
+        DocValue v;
+        v.type = DocValue::Type::Array;
+        v.length = checkedLength(elementCount);
+        v.items = items;
+        addValue(v);
+    }
+
+    void string(std::string_view value) override {
+        DocValue v;
+        v.type = DocValue::Type::String;
+        v.length = checkedLength(value.size());
+        v.chars = storeText(value);
+        addValue(v);
+    }
+
+    void number(double value) override {
+        DocValue v;
+        v.type = DocValue::Type::Number;
+        v.number = value;
+        addValue(v);
+    }
+
+    void integer(int64_t value) override {
+        DocValue v;
+        v.type = DocValue::Type::Integer;
+        v.integer = value;
+        addValue(v);
+    }
+
+    void boolean(bool value) override {
+        DocValue v;
+        v.type = DocValue::Type::Bool;
+        v.boolean = value;
+        addValue(v);
+    }
+
+    void null() override { addValue(DocValue()); }
+
+private:
+    struct Level {
+        bool isObject;
+        std::string_view pendingKey;
+    };
+
+    JSONDocument& doc;
+    std::vector<Level> open;
+    std::vector<DocValue> valueStack;
+    std::vector<DocMember> memberStack;
+    std::unordered_set<std::string_view> seenKeys;
+
+    // The first occurrence of a key wins, as in JSONObject::emplace:
+    // later duplicates are removed from the top `count` members.
+    // Returns how many are left.
+    size_t dropDuplicates(size_t count) {
+        DocMember* first = memberStack.data() + (memberStack.size() - count);
+        size_t kept = 0;
+        if (count <= 16) {
+            for (size_t i = 0; i < count; i++) {
+                bool seen = false;
+                for (size_t j = 0; j < kept && !seen; j++)
+                    seen = first[j].key == first[i].key;
+                if (!seen)
+                    first[kept++] = first[i];
+            }
+        } else {
+            seenKeys.clear();
+            for (size_t i = 0; i < count; i++) {
+                if (seenKeys.insert(first[i].key).second)
+                    first[kept++] = first[i];
+            }
+        }
+        memberStack.resize(memberStack.size() - (count - kept));
+        return kept;
+    }
+
+    static uint32_t checkedLength(size_t n) {
+        if (n > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("JSON value too large for JSONDocument");
+        return uint32_t(n);
+    }
+
+    // Text borrowed from the document's source buffer is kept as a view;
+    // anything else (decoded escapes) is copied into the arena
+    const char* storeText(std::string_view text) {
+        const char* begin = doc.source.data();
+        if (text.data() >= begin && text.data() + text.size() <= begin + doc.source.size())
+            return text.data();
+        return doc.arena.copyString(text);
+    }
+
+    void addValue(const DocValue& v) {
+        if (open.empty())
+            doc.rootValue = v;
+        else if (open.back().isObject)
+            memberStack.push_back(DocMember{open.back().pendingKey, v});
+        else
+            valueStack.push_back(v);
+    }
+};
+
+JSONDocument JSONDocument::parse(std::string text) {
+    auto owned = std::make_shared<const std::string>(std::move(text));
+    std::string_view view = *owned;
+    return build(std::move(owned), view, ValueSpan{0, view.size()});
+}
+
+JSONDocument JSONDocument::parse(std::shared_ptr<const MappedFile> file) {
+    std::string_view view = file->view();
+    return build(std::move(file), view, ValueSpan{0, view.size()});
+}
+
+JSONDocument JSONDocument::parse(std::shared_ptr<const MappedFile> file, const ValueSpan& span) {
+    std::string_view view = file->view();
+    return build(std::move(file), view, span);
+}
+
+JSONDocument JSONDocument::build(std::shared_ptr<const void> owner, std::string_view text,
+                                 const ValueSpan& span) {
+    JSONDocument doc;
+    doc.sourceOwner = std::move(owner);
+    doc.source = text;
+
+    Tokenizer tokenizer(doc.source.substr(0, span.end));
+    tokenizer.seek(span.begin, span.line, span.lineStart);
+    tokenizer.enableStructuralIndex();
+
+    DocumentBuilder builder(doc);
+    Parser(tokenizer).parse(builder);
+    return doc;
+}
+
+JSONDocument JSONDocument::buildElements(std::shared_ptr<const void> owner, std::string_view text,
+                                         const ValueSpan* elements, size_t count) {
+    JSONDocument doc;
+    doc.sourceOwner = std::move(owner);
+    doc.source = text;
+
+    // Every element is parsed as a root value into one open array, so
+    // they all share this document's arena
+    DocumentBuilder builder(doc);
+    builder.startArray();
+    for (size_t i = 0; i < count; i++) {
+        const ValueSpan& e = elements[i];
+        Tokenizer tokenizer(doc.source.substr(0, e.end));
+        tokenizer.seek(e.begin, e.line, e.lineStart);
+        Parser(tokenizer).parse(builder);
+    }
+    builder.endArray(count);
+    return doc;
+}
+
+JSONDocument JSONDocument::join(std::shared_ptr<const void> owner, std::string_view text,
+                                std::vector<JSONDocument> parts) {
+    JSONDocument doc;
+    doc.sourceOwner = std::move(owner);
+    doc.source = text;
+
+    size_t total = 0;
+    for (const JSONDocument& part : parts)
+        total += part.root().size();
+
+    if (total > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("JSON value too large for JSONDocument");
+
+    DocValue* items = doc.arena.allocateArray<DocValue>(total);
+    size_t n = 0;
+    for (const JSONDocument& part : parts) {
+        const DocValue& array = part.root();
+        std::copy(array.items, array.items + array.length, items + n);
+        n += array.length;
+    }
+
+    doc.rootValue.type = DocValue::Type::Array;
+    doc.rootValue.length = uint32_t(total);
+    doc.rootValue.items = items;
+    doc.parts = std::move(parts);
+    return doc;
+}
@@ -1,4 +1,5 @@
 #include "../include/JSONNavigator.h"
+#include <cctype>
 #include <stdexcept>
 
 JSONValue& JSONNavigator::get(JSONValue& root, const std::vector<PathElement>& path) {
@@ -22,12 +23,106 @@ JSONValue& JSONNavigator::get(JSONValue& root, const std::vector<PathElement>& p
                 throw std::runtime_error("Expected object in path");
 
             JSONObject& obj = current->asObject();
-            if (!obj.count(p.key))
+            auto it = obj.find(p.key);   // one lookup, no key allocation
+            if (it == obj.end())
                 throw std::runtime_error("Key not found: " + p.key);
 
-            current = obj[p.key].get();
+            current = it->second.get();
         }
     }
 
     return *current;
 }
+
+const DocValue& JSONNavigator::get(const DocValue& root, const std::vector<PathElement>& path) {
+    const DocValue* current = &root;
+
+    for (const auto& p : path) {
+        if (p.isIndex) {
+            if (!current->isArray())
+                throw std::runtime_error("Expected array in path");
+
+            if (p.index < 0 || p.index >= (int)current->size())
+                throw std::runtime_error("Array index out of bounds");
+
+            current = &(*current)[p.index];
+        }
+        else {
+            if (!current->isObject())
+                throw std::runtime_error("Expected object in path");
+
+            const DocValue* next = current->find(p.key);
+            if (!next)
+                throw std::runtime_error("Key not found: " + p.key);
+
+            current = next;
+        }
+    }
+
+    return *current;
+}
+
+SnapValue JSONNavigator::get(const SnapValue& root, const std::vector<PathElement>& path) {
+    SnapValue current = root;
+
+    for (const auto& p : path) {
+        if (p.isIndex) {
+            if (!current.isArray())
+                throw std::runtime_error("Expected array in path");
+
+            if (p.index < 0 || p.index >= (int)current.size())
+                throw std::runtime_error("Array index out of bounds");
+
+            current = current[p.index];
+        }
+        else {
+            if (!current.isObject())
+                throw std::runtime_error("Expected object in path");
+
+            std::optional<SnapValue> next = current.find(p.key);
+            if (!next)
+                throw std::runtime_error("Key not found: " + p.key);
+
+            current = *next;
+        }
+    }
+
+    return current;
+}
+
+// Auto-detect the JSON type of a command-line value (used by "set")
+JSONValue JSONNavigator::valueFromString(const std::string& s) {
+    if (s == "true")  return JSONValue(true);
+    if (s == "false") return JSONValue(false);
+    if (s == "null")  return JSONValue(nullptr);
+
+    bool isNum = true;
+    bool hasDot = false;
+
+    for (char c : s) {
+        if (c == '.') hasDot = true;
+        else if (!isdigit(static_cast<unsigned char>(c)) && c != '-') isNum = false;
+    }
+
+    if (isNum && !hasDot) {
+        try {
+            size_t used = 0;
+            long long v = std::stoll(s, &used);
+            if (used == s.size())
+                return JSONValue(int64_t(v));   // exact, even above 2^53
+        } catch (...) {}
+    }
+
+    if (isNum) {
+        try {
+            double v = std::stod(s);
+            return JSONValue(v);
+        } catch (...) {}
+    }
+
+    // string with quotes → remove quotes
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
+        return JSONValue(s.substr(1, s.size() - 2));
+
+    return JSONValue(s);
+}
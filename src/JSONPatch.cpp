@@ -0,0 +1,279 @@
+#include "../include/JSONPatch.h"
+#include "../include/JSONNavigator.h"
+#include "../include/JSONPath.h"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Parent of the pointer's target plus the last reference token; no
+// parent means the target is the document itself
+struct Location {
+    JSONValue* parent = nullptr;
+    std::string token;
+};
+
+// "-" (one past the end) is only a valid position to insert at
+size_t arrayIndex(const std::string& token, size_t size, bool insert) {
+    if (insert && token == "-")
+        return size;
+
+    bool digits = !token.empty() && token.size() <= 9 && (token.size() == 1 || token[0] != '0');
+    for (char c : token)
+        digits = digits && c >= '0' && c <= '9';
+    if (!digits)
+        throw std::runtime_error("Invalid array index: " + token);
+
+    size_t index = std::stoul(token);
+    if (index > size || (index == size && !insert))
+        throw std::runtime_error("Array index out of bounds");
+    return index;
+}
+
+// Walks every token but the last with the navigator
+Location locate(JSONValue& root, const std::string& pointer) {
+    std::vector<std::string> tokens = JSONPath::parsePointer(pointer);
+    Location location;
+    if (tokens.empty())
+        return location;
+
+    JSONValue* current = &root;
+    for (size_t i = 0; i + 1 < tokens.size(); i++) {
+        PathElement step = current->isArray()
+            ? PathElement{true, "", int(arrayIndex(tokens[i], current->asArray().size(), false))}
+            : PathElement{false, tokens[i], -1};
+        current = &JSONNavigator::get(*current, {step});
+    }
+
+    location.parent = current;
+    location.token = tokens.back();
+    return location;
+}
+
+JSONValue& target(JSONValue& root, const Location& at) {
+    if (!at.parent)
+        return root;
+    if (at.parent->isArray()) {
+        JSONArray& arr = at.parent->asArray();
+        return *arr[arrayIndex(at.token, arr.size(), false)];
+    }
+    return JSONNavigator::get(*at.parent, {PathElement{false, at.token, -1}});
+}
+
+void add(JSONValue& root, const Location& at, JSONValue value) {
+    if (!at.parent) {
+        root = std::move(value);
+        return;
+    }
+    if (at.parent->isArray()) {
+        JSONArray& arr = at.parent->asArray();
+        size_t index = arrayIndex(at.token, arr.size(), true);
+        arr.insert(arr.begin() + index, std::make_shared<JSONValue>(std::move(value)));
+        return;
+    }
+    if (!at.parent->isObject())
+        throw std::runtime_error("Expected object in path");
+
+    JSONObject& obj = at.parent->asObject();
+    auto it = obj.find(at.token);
+    if (it != obj.end())
+        *it->second = std::move(value);
+    else
+        obj.emplace(JSONKey(at.token), std::make_shared<JSONValue>(std::move(value)));
+}
+
+JSONValue remove(const Location& at) {
+    if (!at.parent)
+        throw std::runtime_error("Cannot remove the whole document");
+
+    if (at.parent->isArray()) {
+        JSONArray& arr = at.parent->asArray();
+        size_t index = arrayIndex(at.token, arr.size(), false);
+        JSONValue removed = std::move(*arr[index]);
+        arr.erase(arr.begin() + index);
+        return removed;
+    }
+    if (!at.parent->isObject())
+        throw std::runtime_error("Expected object in path");
+
+    JSONObject& obj = at.parent->asObject();
+    auto it = obj.find(at.token);
+    if (it == obj.end())
+        throw std::runtime_error("Key not found: " + at.token);
+    JSONValue removed = std::move(*it->second);
+    obj.erase(it);
+    return removed;
+}
+
+// The value itself for a scalar, an empty container of the same kind
+// otherwise
+JSONValue shallowCopy(const JSONValue& value) {
+    if (value.isArray())
+        return JSONValue(JSONArray());
+    if (value.isObject())
+        return JSONValue(JSONObject());
+    return value;
+}
+
+// Copying a JSONValue shares its children; "copy" needs its own.
+// Containers are filled from a worklist, so depth costs heap, not stack.
+JSONValue deepCopy(const JSONValue& value) {
+    JSONValue root = shallowCopy(value);
+    std::vector<std::pair<const JSONValue*, JSONValue*>> pending{{&value, &root}};
+
+    while (!pending.empty()) {
+        auto [from, to] = pending.back();
+        pending.pop_back();
+
+        if (from->isArray()) {
+            JSONArray& copy = to->asArray();
+            copy.reserve(from->asArray().size());
+            for (const auto& element : from->asArray()) {
+                copy.push_back(std::make_shared<JSONValue>(shallowCopy(*element)));
+                pending.emplace_back(element.get(), copy.back().get());
+            }
+        }
+        else if (from->isObject()) {
+            JSONObject& copy = to->asObject();
+            copy.reserve(from->asObject().size());
+            for (const auto& [key, member] : from->asObject()) {
+                auto child = std::make_shared<JSONValue>(shallowCopy(*member));
+                pending.emplace_back(member.get(), child.get());
+                copy.emplace(key, std::move(child));
+            }
+        }
+    }
+    return root;
+}
+
+// Structural equality, walked with a worklist of pairs still to compare
+bool equal(const JSONValue& first, const JSONValue& second) {
+    std::vector<std::pair<const JSONValue*, const JSONValue*>> pending{{&first, &second}};
+
+    while (!pending.empty()) {
+        auto [a, b] = pending.back();
+        pending.pop_back();
+
+        if (a->isNumber() && b->isNumber()) {
+            bool same = a->isInteger() && b->isInteger() ? a->asInteger() == b->asInteger()
+                                                         : a->asNumber() == b->asNumber();
+            if (!same)
+                return false;
+            continue;
+        }
+        if (a->index() != b->index())
+            return false;
+
+        if (a->isArray()) {
+            const JSONArray& x = a->asArray();
+            const JSONArray& y = b->asArray();
+            if (x.size() != y.size())
+                return false;
+            for (size_t i = 0; i < x.size(); i++)
+                pending.emplace_back(x[i].get(), y[i].get());
+        }
+        else if (a->isObject()) {
+            const JSONObject& x = a->asObject();
+            const JSONObject& y = b->asObject();
+            if (x.size() != y.size())
+                return false;
+            for (const auto& [key, member] : x) {
+                auto it = y.find(key);
+                if (it == y.end())
+                    return false;
+                pending.emplace_back(member.get(), it->second.get());
+            }
+        }
+        else if (a->isString()) {
+            if (a->asString() != b->asString())
+                return false;
+        }
+        else if (a->isBool()) {
+            if (a->asBool() != b->asBool())
+                return false;
+        }
+        // both null
+    }
+    return true;
+}
+
+const JSONValue& field(const JSONValue& op, const char* name) {
+    auto it = op.asObject().find(name);
+    if (it == op.asObject().end())
+        throw std::runtime_error(std::string("Missing '") + name + "'");
+    return *it->second;
+}
+
+const std::string& pointerField(const JSONValue& op, const char* name) {
+    const JSONValue& value = field(op, name);
+    if (!value.isString())
+        throw std::runtime_error(std::string("'") + name + "' must be a JSON Pointer string");
+    return value.asString();
+}
+
+void applyOne(JSONValue& root, const JSONValue& op) {
+    if (!op.isObject())
+        throw std::runtime_error("Operation must be an object");
+
+    const JSONValue& name = field(op, "op");
+    const std::string kind = name.isString() ? name.asString() : std::string();
+    const std::string& path = pointerField(op, "path");
+
+    if (kind == "add") {
+        add(root, locate(root, path), deepCopy(field(op, "value")));
+    }
+    else if (kind == "remove") {
+        remove(locate(root, path));
+    }
+    else if (kind == "replace") {
+        target(root, locate(root, path)) = deepCopy(field(op, "value"));
+    }
+    else if (kind == "move") {
+        const std::string& from = pointerField(op, "from");
+        if (from == path) {
+            // A no-op, but "from" must still exist; removing and adding
+            // back would move an object member to the end
+            target(root, locate(root, from));
+            return;
+        }
+        if (path.compare(0, from.size() + 1, from + "/") == 0)
+            throw std::runtime_error("Cannot move a value into one of its own children");
+        JSONValue value = remove(locate(root, from));
+        add(root, locate(root, path), std::move(value));
+    }
+    else if (kind == "copy") {
+        JSONValue value = deepCopy(target(root, locate(root, pointerField(op, "from"))));
+        add(root, locate(root, path), std::move(value));
+    }
+    else if (kind == "test") {
+        if (!equal(target(root, locate(root, path)), field(op, "value")))
+            throw std::runtime_error("Test failed: value at '" + path + "' differs");
+    }
+    else {
+        throw std::runtime_error("Unknown op: " + (kind.empty() ? std::string("(not a string)") : kind));
+    }
+}
+
+} // namespace
+
+size_t JSONPatch::apply(JSONValue& document, const JSONValue& patch) {
+    if (!patch.isArray())
+        throw std::runtime_error("A JSON Patch must be an array of operations");
+
+    const JSONArray& ops = patch.asArray();
+    for (size_t i = 0; i < ops.size(); i++) {
+        try {
+            applyOne(document, *ops[i]);
+        } catch (const std::runtime_error& e) {
+            std::string kind;
+            if (ops[i]->isObject()) {
+                auto it = ops[i]->asObject().find("op");
+                if (it != ops[i]->asObject().end() && it->second->isString())
+                    kind = " (" + it->second->asString() + ")";
+            }
+            throw std::runtime_error("Patch operation " + std::to_string(i) + kind + ": " + e.what());
+        }
+    }
+    return ops.size();
+}
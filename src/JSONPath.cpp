@@ -49,3 +49,31 @@ std::vector<PathElement> JSONPath::parse(const std::string& path) {
 
     return result;
 }
+
+std::vector<std::string> JSONPath::parsePointer(const std::string& pointer) {
+    std::vector<std::string> tokens;
+    if (pointer.empty())
+        return tokens;
+    if (pointer[0] != '/')
+        throw std::runtime_error("JSON Pointer must start with '/': " + pointer);
+
+    for (size_t i = 1; ; i++) {
+        std::string token;
+        for (; i < pointer.size() && pointer[i] != '/'; i++) {
+            if (pointer[i] != '~') {
+                token += pointer[i];
+                continue;
+            }
+            // ~0 is '~', ~1 is '/'
+            char next = i + 1 < pointer.size() ? pointer[i + 1] : '\0';
+            if (next != '0' && next != '1')
+                throw std::runtime_error("Invalid escape in JSON Pointer: " + pointer);
+            token += next == '0' ? '~' : '/';
+            i++;
+        }
+        tokens.push_back(token);
+        if (i >= pointer.size())
+            break;
+    }
+    return tokens;
+}
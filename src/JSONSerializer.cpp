@@ -1,149 +1,359 @@
 #include "JSONSerializer.h"
 #include "JSONUtils.h"
-#include <sstream>
-#include <iomanip>
 
-std::string JSONSerializer::indentString(int indent) {
-    return std::string(indent * 2, ' ');
+namespace {
+
+// Tree adapters, so one writer walk serves JSONValue, DocValue and
+// SnapValue. The walk keeps its containers on a stack: tree nodes by
+// address, snapshot values (decoded on the fly) by value.
+template <class Value>
+struct Held {
+    const Value* node;
+    Held(const Value& v) : node(&v) {}
+    const Value& get() const { return *node; }
+};
+
+template <>
+struct Held<SnapValue> {
+    SnapValue node;
+    Held(const SnapValue& v) : node(v) {}
+    const SnapValue& get() const { return node; }
+};
+
+template <class Value>
+struct Member {
+    std::string_view key;
+    Held<Value> value;
+};
+
+size_t childCount(const JSONValue& v) { return v.isArray() ? v.asArray().size() : v.asObject().size(); }
+const JSONValue& element(const JSONValue& v, size_t i) { return *v.asArray()[i]; }
+Member<JSONValue> member(const JSONValue& v, size_t i) {
+    const auto& m = *(v.asObject().begin() + i);
+    return {m.first, *m.second};
 }
 
-std::string JSONSerializer::serialize(const JSONValue& value, int indent) {
+// Members in input order
+size_t childCount(const DocValue& v) { return v.size(); }
+const DocValue& element(const DocValue& v, size_t i) { return v.items[i]; }
+Member<DocValue> member(const DocValue& v, size_t i) { return {v.members[i].key, v.members[i].value}; }
+
+size_t childCount(const SnapValue& v) { return v.size(); }
+SnapValue element(const SnapValue& v, size_t i) { return v[i]; }
+Member<SnapValue> member(const SnapValue& v, size_t i) {
+    SnapMember m = v.member(i);
+    return {m.key, m.value};
+}
+
+// Writes a scalar whole; false for a container
+template <class Value>
+bool writeScalar(const Value& value, JSONWriter& out) {
 
     // STRING
     if (value.isString()) {
-        return "\"" + JSONUtils::escapeString(value.asString()) + "\"";
+        out.string(value.asString());
+        return true;
     }
 
-    // NUMBER
+    // NUMBER (exact integers first)
+    if (value.isInteger()) {
+        out.integer(value.asInteger());
+        return true;
+    }
     if (value.isNumber()) {
-        return JSONUtils::formatNumber(value.asNumber());
+        out.number(value.asNumber());
+        return true;
     }
 
     // BOOLEAN
     if (value.isBool()) {
-        return value.asBool() ? "true" : "false";
+        out.put(value.asBool() ? "true" : "false");
+        return true;
     }
 
     // NULL
     if (value.isNull()) {
-        return "null";
+        out.put("null");
+        return true;
     }
 
-    // ARRAY
-    if (value.isArray()) {
-        const JSONArray& arr = value.asArray();
-        std::ostringstream out;
-        out << "[\n";
-
-        for (size_t i = 0; i < arr.size(); i++) {
-            out << indentString(indent + 1)
-                << serialize(arr[i], indent + 1);
-
-            if (i + 1 < arr.size())
-                out << ",";
+    return false;
+}
 
-            out << "\n";
+// Depth-first, with the open containers on an explicit stack instead of
+// the call stack, so output depth costs one small frame of heap per level
+template <class Value>
+void writeValue(const Value& root, JSONWriter& out, int indent, bool pretty) {
+    struct Frame {
+        Held<Value> container;
+        size_t next;        // next element / member to write
+        size_t count;
+        bool object;
+    };
+    std::vector<Frame> open;
+    Held<Value> value(root);
+
+    for (;;) {
+        // ARRAY / OBJECT: opening bracket, then the contents one by one
+        if (!writeScalar(value.get(), out)) {
+            bool object = value.get().isObject();
+            out.put(object ? '{' : '[');
+            open.push_back(Frame{value, 0, childCount(value.get()), object});
         }
 
-        out << indentString(indent) << "]";
-        return out.str();
+        // Next element or member of the innermost open container; the
+        // finished ones are closed on the way up
+        for (;;) {
+            if (open.empty())
+                return;
+
+            Frame& top = open.back();
+            int depth = indent + int(open.size());
+            if (top.next < top.count) {
+                if (top.next > 0)
+                    out.put(',');
+                if (pretty)
+                    out.newline(depth);
+
+                if (top.object) {
+                    Member<Value> m = member(top.container.get(), top.next++);
+                    out.string(m.key);
+                    out.put(pretty ? ": " : ":");
+                    value = m.value;
+                } else {
+                    value = Held<Value>(element(top.container.get(), top.next++));
+                }
+                break;
+            }
+
+            if (pretty)
+                out.newline(depth - 1);
+            out.put(top.object ? '}' : ']');
+            open.pop_back();
+        }
     }
+}
 
-    // OBJECT
-    if (value.isObject()) {
-        const JSONObject& obj = value.asObject();
-        std::ostringstream out;
-        out << "{\n";
+} // namespace
 
-        size_t count = 0;
-        for (auto& p : obj) {
-            out << indentString(indent + 1)
-                << "\"" << JSONUtils::escapeString(p.first) << "\": "
-                << serialize(p.second, indent + 1);
+void JSONSerializer::write(const JSONValue& value, JSONWriter& out, int indent) {
+    writeValue(value, out, indent, true);
+}
 
-            if (++count < obj.size())
-                out << ",";
+void JSONSerializer::writeCompact(const JSONValue& value, JSONWriter& out) {
+    writeValue(value, out, 0, false);
+}
 
-            out << "\n";
-        }
+void JSONSerializer::write(const DocValue& value, JSONWriter& out, int indent) {
+    writeValue(value, out, indent, true);
+}
 
-        out << indentString(indent) << "}";
-        return out.str();
-    }
+void JSONSerializer::writeCompact(const DocValue& value, JSONWriter& out) {
+    writeValue(value, out, 0, false);
+}
+
+void JSONSerializer::write(const SnapValue& value, JSONWriter& out, int indent) {
+    writeValue(value, out, indent, true);
+}
 
-    return "";
+void JSONSerializer::writeCompact(const SnapValue& value, JSONWriter& out) {
+    writeValue(value, out, 0, false);
+}
+
+std::string JSONSerializer::serialize(const JSONValue& value, int indent) {
+    JSONWriter out;
+    write(value, out, indent);
+    return out.take();
+}
+
+std::string JSONSerializer::serialize(const std::shared_ptr<JSONValue>& ptr, int indent) {
+    return serialize(*ptr, indent);
 }
 
 std::string JSONSerializer::serializeCompact(const JSONValue& value) {
-    // STRING
-    if (value.isString()) {
-        return "\"" + JSONUtils::escapeString(value.asString()) + "\"";
-    }
+    JSONWriter out;
+    writeCompact(value, out);
+    return out.take();
+}
 
-    // NUMBER
-    if (value.isNumber()) {
-        return JSONUtils::formatNumber(value.asNumber());
+std::string JSONSerializer::serialize(const DocValue& value, int indent) {
+    JSONWriter out;
+    write(value, out, indent);
+    return out.take();
+}
+
+std::string JSONSerializer::serializeCompact(const DocValue& value) {
+    JSONWriter out;
+    writeCompact(value, out);
+    return out.take();
+}
+
+// ====================================================
+// SerializingHandler
+// ====================================================
+
+// Separator + line break before an element or a member's key
+namespace {
+
+// Objects up to this many keys are checked for duplicates by scanning
+constexpr size_t keyScanLimit = 16;
+
+} // namespace
+
+// Records `name` for the innermost object; true when it was already there
+bool SerializingHandler::duplicateKey(std::string_view name) {
+    Level& level = open.back();
+    if (level.wide)
+        return !wideKeys.back().emplace(name).second;
+
+    // Keys differing in length or first byte mostly land on different
+    // bits, so a new key rarely needs the scan
+    auto text = [this](const KeyRef& key) { return std::string_view(keyText.data() + key.offset, key.size); };
+    uint64_t bit = uint64_t(1) << ((name.size() + (name.empty() ? 0 : unsigned(uint8_t(name[0])))) & 63);
+    if (level.seen & bit) {
+        for (size_t i = level.firstKey; i < keys.size(); i++) {
+            if (keys[i].size == name.size() && text(keys[i]) == name)
+                return true;
+        }
+    }
+    level.seen |= bit;
+    keys.push_back(KeyRef{keyText.size(), name.size()});
+    keyText.append(name.data(), name.size());
+
+    if (keys.size() - level.firstKey > keyScanLimit) {
+        level.wide = true;
+        wideKeys.emplace_back();
+        for (size_t i = level.firstKey; i < keys.size(); i++)
+            wideKeys.back().emplace(text(keys[i]));
+        keyText.resize(keys[level.firstKey].offset);
+        keys.resize(level.firstKey);
     }
+    return false;
+}
 
-    // BOOLEAN
-    if (value.isBool()) {
-        return value.asBool() ? "true" : "false";
+// Swallows the events of a dropped member's value: `nesting` is +1 for
+// a start event, -1 for an end event and 0 for a scalar or key
+bool SerializingHandler::skipped(int nesting) {
+    if (skip == 0)
+        return false;
+    skip = size_t(int64_t(skip) + nesting);
+    if (skip == 1 && nesting <= 0)
+        skip = 0;   // the value is complete
+    return true;
+}
+
+void SerializingHandler::nextItem() {
+    if (open.back().items++ > 0)
+        out.put(',');
+    if (pretty)
+        out.newline(int(open.size()));
+}
+
+// A member's value follows its key directly; anything else is an item
+void SerializingHandler::beginValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
     }
+    if (!open.empty())
+        nextItem();
+}
 
-    // NULL
-    if (value.isNull()) {
-        return "null";
+void SerializingHandler::close(char bracket) {
+    size_t firstKey = open.back().firstKey;
+    if (open.back().wide)
+        wideKeys.pop_back();
+    if (firstKey < keys.size()) {
+        keyText.resize(keys[firstKey].offset);
+        keys.resize(firstKey);
     }
+    open.pop_back();
+    if (pretty)
+        out.newline(int(open.size()));
+    out.put(bracket);
+}
 
-    // ARRAY
-    if (value.isArray()) {
-        const JSONArray& arr = value.asArray();
-        std::ostringstream out;
-        out << "[";
+void SerializingHandler::startObject() {
+    if (skipped(+1))
+        return;
+    beginValue();
+    out.put('{');
+    open.push_back(Level{0, keys.size(), false, 0});
+}
 
-        for (size_t i = 0; i < arr.size(); i++) {
-            out << serializeCompact(*arr[i]);
+void SerializingHandler::key(std::string_view name) {
+    if (skipped(0))
+        return;
+    if (duplicateKey(name)) {
+        skip = 1;
+        return;
+    }
+    nextItem();
+    out.string(name);
+    out.put(pretty ? ": " : ":");
+    afterKey = true;
+}
 
-            if (i + 1 < arr.size())
-                out << ",";
-        }
+void SerializingHandler::endObject(size_t) {
+    if (!skipped(-1))
+        close('}');
+}
 
-        out << "]";
-        return out.str();
-    }
+void SerializingHandler::startArray() {
+    if (skipped(+1))
+        return;
+    beginValue();
+    out.put('[');
+    open.push_back(Level{0, keys.size(), false, 0});
+}
 
-    // OBJECT
-    if (value.isObject()) {
-        const JSONObject& obj = value.asObject();
-        std::ostringstream out;
-        out << "{";
+void SerializingHandler::endArray(size_t) {
+    if (!skipped(-1))
+        close(']');
+}
 
-        size_t count = 0;
-        for (auto& p : obj) {
-            out << "\"" << JSONUtils::escapeString(p.first) << "\":"
-                << serializeCompact(*p.second);
+void SerializingHandler::string(std::string_view value) {
+    if (skipped(0))
+        return;
+    beginValue();
+    out.string(value);
+}
 
-            if (++count < obj.size())
-                out << ",";
-        }
+void SerializingHandler::number(double value) {
+    if (skipped(0))
+        return;
+    beginValue();
+    out.number(value);
+}
 
-        out << "}";
-        return out.str();
-    }
+void SerializingHandler::integer(int64_t value) {
+    if (skipped(0))
+        return;
+    beginValue();
+    out.integer(value);
+}
 
-    return "";
+void SerializingHandler::boolean(bool value) {
+    if (skipped(0))
+        return;
+    beginValue();
+    out.put(value ? "true" : "false");
 }
 
-std::string JSONSerializer::serialize(const std::shared_ptr<JSONValue>& ptr, int indent) {
-    return serialize(*ptr, indent);
+void SerializingHandler::null() {
+    if (skipped(0))
+        return;
+    beginValue();
+    out.put("null");
 }
 
 
 
 /* 
-====================== JSON SERIALIZER — RECURSION TREE ======================
+====================== JSON SERIALIZER — WALK ORDER ======================
 
-This is how the serializer calls itself recursively for a JSON like:
+The serializer visits the tree depth-first, like a recursive writer
+would, but keeps the open containers on its own stack. For a JSON like:
 
 {
   "profile": {
@@ -151,38 +361,40 @@ This is how the serializer calls itself recursively for a JSON like:
     "year": 3
   },
   "marks": [98, 99, 93],
-  "nickname": null,
-  "height": -5.8,
-  "student": true,
-  "age": 21,
   "name": "Ranveer"
 }
 
-CALL TREE (indent value shown in parentheses):
-
-serialize(root, 0)                  // OBJECT
-│
-├── serialize(profile_value, 1)
-│   └── serialize(profile_object, 2)
-│       ├── serialize("Delhi University", 3)
-│       └── serialize(3, 3)
-│
-├── serialize(marks_value, 1)
-│   └── serialize(marks_array, 2)
-│       ├── serialize(98, 3)
-│       ├── serialize(99, 3)
-│       └── serialize(93, 3)
-│
-├── serialize(null, 1)
-├── serialize(-5.8, 1)
-├── serialize(true, 1)
-├── serialize(21, 1)
-└── serialize("Ranveer", 1)
+STACK WHILE WRITING (innermost last):
+
+  writes                       open containers (next child)
+  {                            root(0)
+  "profile": {                 root(1) profile(0)
+  "college": "Delhi Univ..."   root(1) profile(1)
+  "year": 3                    root(1) profile(2)
+  }                            root(1)             ← profile done, popped
+  "marks": [                   root(2) marks(0)
+  98, 99, 93                   root(2) marks(3)
+  ]                            root(2)
+  "name": "Ranveer"            root(3)
+  }                            (empty: done)
 
 NOTES:
-- indent = depth level inside nested objects/arrays
-- indentString(indent) prints (indent * 2) spaces
-- Arrays and objects increase indent by +1 for their contents
-- Each call returns a string to its parent, building the final JSON
-==============================================================================
+- the indent of a line is the number of open containers (plus the
+  caller's starting indent); each level is two spaces
+- every step appends to the same JSONWriter buffer, so each output
+  byte is written exactly once
+- depth costs one small stack entry on the heap, never a call frame
+==========================================================================
 */
+
+std::string JSONSerializer::serialize(const SnapValue& value, int indent) {
+    JSONWriter out;
+    write(value, out, indent);
+    return out.take();
+}
+
+std::string JSONSerializer::serializeCompact(const SnapValue& value) {
+    JSONWriter out;
+    writeCompact(value, out);
+    return out.take();
+}
@@ -0,0 +1,161 @@
+#include "../include/JSONService.h"
+#include "../include/JSONCursor.h"
+#include "../include/JSONDocument.h"
+#include "../include/JSONNavigator.h"
+#include "../include/JSONPath.h"
+#include "../include/JSONSerializer.h"
+#include "../include/JSONWriter.h"
+#include "../include/parser.h"
+#include "../include/tokenizer.h"
+#include <optional>
+
+namespace {
+
+HTTPResponse reply(int status, std::string_view result, std::string_view error) {
+    HTTPResponse response;
+    response.status = status;
+
+    JSONWriter out(response.body);
+    out.put('{');
+    out.string("result");
+    out.put(':');
+    out.string(result);
+    out.put(',');
+    out.string("error");
+    out.put(':');
+    out.string(error);
+    out.put('}');
+    return response;
+}
+
+std::string describe(const JSONParseError& e) {
+    return "JSON Parse Error at line " + std::to_string(e.line) + ", column "
+         + std::to_string(e.column) + ": " + e.what();
+}
+
+// ---- Endpoints on a raw JSON body ----
+
+std::string validate(const std::string& text) {
+    Tokenizer tokenizer(text);
+    tokenizer.enableStructuralIndex();
+    JSONHandler ignoreEvents;
+    Parser(tokenizer).parse(ignoreEvents);
+    return "[OK] Valid JSON";
+}
+
+std::string transcode(const std::string& text, bool pretty) {
+    std::string result;
+    JSONWriter out(result);
+    Tokenizer tokenizer(text);
+    tokenizer.enableStructuralIndex();
+    SerializingHandler handler(out, pretty);
+    Parser(tokenizer).parse(handler);
+    return result;
+}
+
+// The CLI's printer writes the same layout as pretty serialization
+std::string show(const std::string& text) {
+    JSONDocument doc = JSONDocument::parse(text);
+    return JSONSerializer::serialize(doc.root());
+}
+
+// ---- Endpoints on a {"json", "path", ...} envelope ----
+
+struct Envelope {
+    JSONDocument doc;
+    const DocValue* json = nullptr;
+    std::string path;
+    const DocValue* value = nullptr;
+};
+
+// Fills `envelope`, or returns the 400 reply to send
+std::optional<HTTPResponse> readEnvelope(const std::string& body, bool withValue, Envelope& envelope) {
+    const char* missing = withValue ? "Missing 'json', 'path', or 'value' in request body"
+                                    : "Missing 'json' or 'path' in request body";
+    try {
+        envelope.doc = JSONDocument::parse(body);
+    } catch (const JSONParseError& e) {
+        return reply(400, "", "Request body is not valid JSON: " + describe(e));
+    }
+
+    const DocValue& root = envelope.doc.root();
+    if (!root.isObject())
+        return reply(400, "", missing);
+
+    const DocValue* path = root.find("path");
+    envelope.json = root.find("json");
+    envelope.value = withValue ? root.find("value") : nullptr;
+    if (!envelope.json || !path || (withValue && !envelope.value))
+        return reply(400, "", missing);
+    if (!path->isString())
+        return reply(400, "", "'path' must be a string");
+
+    envelope.path = std::string(path->asString());
+    return std::nullopt;
+}
+
+std::string get(const Envelope& envelope) {
+    auto path = JSONPath::parse(envelope.path);
+    if (!envelope.json->isString())
+        return JSONSerializer::serialize(JSONNavigator::get(*envelope.json, path));
+
+    JSONDocument doc = JSONDocument::parse(std::string(envelope.json->asString()));
+    return JSONSerializer::serialize(JSONNavigator::get(doc.root(), path));
+}
+
+// JSON text is spliced like the CLI's set (formatting kept); a
+// document given inline is edited and pretty-printed
+std::string set(const Envelope& envelope) {
+    auto path = JSONPath::parse(envelope.path);
+    JSONValue value = envelope.value->isString()
+        ? JSONNavigator::valueFromString(std::string(envelope.value->asString()))
+        : envelope.value->toValue();
+
+    if (envelope.json->isString()) {
+        std::string_view text = envelope.json->asString();
+        ValueSpan span = JSONCursor(text).locateChecked(path);
+        return std::string(text.substr(0, span.begin)) + JSONSerializer::serializeCompact(value)
+             + std::string(text.substr(span.end));
+    }
+
+    JSONValue root = envelope.json->toValue();
+    JSONNavigator::get(root, path) = std::move(value);
+    return JSONSerializer::serialize(root);
+}
+
+} // namespace
+
+HTTPResponse JSONService::handle(const HTTPRequest& request) {
+    const std::string& route = request.path;
+    bool known = route == "/validate" || route == "/pretty" || route == "/minify"
+              || route == "/show" || route == "/get" || route == "/set";
+    if (!known)
+        return reply(404, "", "Unknown endpoint: " + route);
+    if (request.method != "POST")
+        return reply(405, "", "Use POST for " + route);
+
+    try {
+        if (route == "/get" || route == "/set") {
+            Envelope envelope;
+            bool isSet = route == "/set";
+            if (auto rejected = readEnvelope(request.body, isSet, envelope))
+                return *rejected;
+            return reply(200, isSet ? set(envelope) : get(envelope), "");
+        }
+
+        if (request.body.empty())
+            return reply(400, "", "Empty request body");
+
+        if (route == "/validate")
+            return reply(200, validate(request.body), "");
+        if (route == "/show")
+            return reply(200, show(request.body), "");
+        return reply(200, transcode(request.body, route == "/pretty"), "");
+    }
+    catch (const JSONParseError& e) {
+        return reply(200, "", describe(e));
+    }
+    catch (const std::runtime_error& e) {
+        return reply(200, "", e.what());
+    }
+}
@@ -0,0 +1,258 @@
+#include "../include/JSONSnapshot.h"
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const char snapshotMagic[8] = {'J', 'S', 'O', 'N', 'S', 'N', 'A', 'P'};
+constexpr uint32_t byteOrderTag = 0x01020304;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;     // byteOrderTag as written by the compiling machine
+    uint64_t fileSize;
+    uint64_t rootOffset;
+};
+
+static_assert(sizeof(Header) == 32, "snapshot header is 32 bytes");
+
+// Records may sit at any alignment in a heap-read file, so they are
+// always copied out (compiles to a plain load)
+template <class T>
+T load(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("Corrupt snapshot: offset out of range");
+}
+
+// ====================================================
+// Compiler — writes the tree depth-first. A container's record is
+// reserved before its contents, so every offset followed when reading
+// points forward; a corrupt file can't send the reader in a cycle.
+// ====================================================
+class Compiler {
+public:
+    std::string out;
+
+    // Zeroed, 8-byte aligned block
+    uint64_t reserve(size_t bytes) {
+        out.resize((out.size() + 7) & ~size_t(7));
+        uint64_t at = out.size();
+        out.resize(out.size() + bytes);
+        return at;
+    }
+
+    // Work items are taken last-in first-out and a container queues its
+    // children in reverse, so the tree is still written depth-first in
+    // input order, without one call frame per level
+    void write(uint64_t at, const DocValue& root) {
+        struct Item {
+            uint64_t at;
+            const DocValue* value;
+        };
+        std::vector<Item> work{Item{at, &root}};
+
+        while (!work.empty()) {
+            Item item = work.back();
+            work.pop_back();
+            const DocValue& v = *item.value;
+
+            SnapRecord r;
+            switch (v.type) {
+                case DocValue::Type::Null:
+                    r.tag = SnapTag::Null;
+                    break;
+                case DocValue::Type::Bool:
+                    r.tag = SnapTag::Bool;
+                    r.payload = v.boolean ? 1 : 0;
+                    break;
+                case DocValue::Type::Number:
+                    r.tag = SnapTag::Number;
+                    std::memcpy(&r.payload, &v.number, sizeof v.number);
+                    break;
+                case DocValue::Type::Integer:
+                    r.tag = SnapTag::Integer;
+                    r.payload = uint64_t(v.integer);
+                    break;
+                case DocValue::Type::String:
+                    r.tag = SnapTag::String;
+                    r.length = v.length;
+                    r.payload = text(v.asString());
+                    break;
+                case DocValue::Type::Array:
+                    r.tag = SnapTag::Array;
+                    r.length = v.length;
+                    r.payload = reserve(size_t(v.length) * sizeof(SnapRecord));
+                    for (uint32_t i = v.length; i-- > 0; )
+                        work.push_back(Item{r.payload + i * sizeof(SnapRecord), &v.items[i]});
+                    break;
+                case DocValue::Type::Object:
+                    r.tag = SnapTag::Object;
+                    r.length = v.length;
+                    r.payload = reserve(size_t(v.length) * sizeof(SnapMemberRecord));
+                    for (uint32_t i = 0; i < v.length; i++) {
+                        const DocMember& m = v.members[i];
+                        SnapMemberRecord mr;
+                        mr.keyOffset = key(m.key);
+                        mr.keyLength = uint32_t(m.key.size());
+                        std::memcpy(&out[r.payload + i * sizeof(SnapMemberRecord)], &mr, offsetof(SnapMemberRecord, value));
+                    }
+                    for (uint32_t i = v.length; i-- > 0; )
+                        work.push_back(Item{r.payload + i * sizeof(SnapMemberRecord) + offsetof(SnapMemberRecord, value),
+                                            &v.members[i].value});
+                    break;
+            }
+            std::memcpy(&out[item.at], &r, sizeof r);
+        }
+    }
+
+private:
+    std::unordered_map<std::string_view, uint64_t> keys;   // distinct keys (views into the document)
+
+    uint64_t text(std::string_view s) {
+        uint64_t at = out.size();
+        out.append(s.data(), s.size());
+        return at;
+    }
+
+    uint64_t key(std::string_view k) {
+        auto it = keys.find(k);
+        if (it != keys.end())
+            return it->second;
+        uint64_t at = text(k);
+        keys.emplace(k, at);
+        return at;
+    }
+};
+
+} // namespace
+
+// ====================================================
+// SnapValue accessors
+// ====================================================
+SnapValue::SnapValue(const char* base, size_t fileSize, uint64_t offset)
+    : base(base), fileSize(fileSize), offset(offset) {
+    if (offset > fileSize || fileSize - offset < sizeof(SnapRecord))
+        corrupt();
+    rec = load<SnapRecord>(base + offset);
+    if (rec.tag > SnapTag::Object)
+        throw std::runtime_error("Corrupt snapshot: unknown value tag");
+}
+
+const char* SnapValue::table(size_t width) const {
+    if (rec.payload <= offset || rec.payload > fileSize
+        || uint64_t(rec.length) * width > fileSize - rec.payload)
+        corrupt();
+    return base + rec.payload;
+}
+
+std::string_view SnapValue::asString() const {
+    if (!isString()) throw std::runtime_error("Not a JSON string");
+    return std::string_view(table(1), rec.length);
+}
+
+double SnapValue::asNumber() const {
+    if (isInteger())
+        return double(int64_t(rec.payload));
+    if (!isNumber()) throw std::runtime_error("Not a JSON number");
+    double value;
+    std::memcpy(&value, &rec.payload, sizeof value);
+    return value;
+}
+
+int64_t SnapValue::asInteger() const {
+    if (!isInteger()) throw std::runtime_error("Not a JSON integer");
+    return int64_t(rec.payload);
+}
+
+bool SnapValue::asBool() const {
+    if (!isBool()) throw std::runtime_error("Not a JSON boolean");
+    return rec.payload != 0;
+}
+
+SnapValue SnapValue::operator[](size_t index) const {
+    if (!isArray()) throw std::runtime_error("Not a JSON array");
+    if (index >= rec.length) throw std::runtime_error("Array index out of bounds");
+    table(sizeof(SnapRecord));
+    return SnapValue(base, fileSize, rec.payload + index * sizeof(SnapRecord));
+}
+
+SnapMember SnapValue::member(size_t index) const {
+    if (!isObject()) throw std::runtime_error("Not a JSON object");
+    if (index >= rec.length) throw std::runtime_error("Object member index out of bounds");
+
+    uint64_t slot = uint64_t(table(sizeof(SnapMemberRecord)) - base) + index * sizeof(SnapMemberRecord);
+    auto mr = load<SnapMemberRecord>(base + slot);
+    if (mr.keyOffset > fileSize || mr.keyLength > fileSize - mr.keyOffset)
+        corrupt();
+
+    return SnapMember{std::string_view(base + mr.keyOffset, mr.keyLength),
+                      SnapValue(base, fileSize, slot + offsetof(SnapMemberRecord, value))};
+}
+
+std::optional<SnapValue> SnapValue::find(std::string_view key) const {
+    if (!isObject()) throw std::runtime_error("Not a JSON object");
+    for (size_t i = 0; i < rec.length; i++) {
+        SnapMember m = member(i);
+        if (m.key == key)
+            return m.value;
+    }
+    return std::nullopt;
+}
+
+// ====================================================
+// JSONSnapshot
+// ====================================================
+bool JSONSnapshot::isSnapshot(std::string_view bytes) {
+    return bytes.size() >= sizeof(snapshotMagic)
+        && std::memcmp(bytes.data(), snapshotMagic, sizeof(snapshotMagic)) == 0;
+}
+
+JSONSnapshot JSONSnapshot::open(std::shared_ptr<const MappedFile> file) {
+    std::string_view bytes = file->view();
+    if (!isSnapshot(bytes) || bytes.size() < sizeof(Header))
+        throw std::runtime_error("Not a JSON snapshot");
+
+    auto header = load<Header>(bytes.data());
+    if (header.byteOrder != byteOrderTag)
+        throw std::runtime_error("Snapshot was compiled on a machine with a different byte order");
+    if (header.version != version)
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version)
+            + " (expected " + std::to_string(version) + ")");
+    if (header.fileSize != bytes.size())
+        throw std::runtime_error("Truncated snapshot");
+
+    JSONSnapshot snapshot;
+    snapshot.file = std::move(file);
+    snapshot.rootOffset = header.rootOffset;
+    snapshot.root();   // validates the root record
+    return snapshot;
+}
+
+SnapValue JSONSnapshot::root() const {
+    return SnapValue(file->data(), file->size(), rootOffset);
+}
+
+std::string JSONSnapshot::compile(const DocValue& root) {
+    Compiler compiler;
+    uint64_t headerAt = compiler.reserve(sizeof(Header));
+    uint64_t rootAt = compiler.reserve(sizeof(SnapRecord));
+    compiler.write(rootAt, root);
+
+    Header header;
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = version;
+    header.byteOrder = byteOrderTag;
+    header.fileSize = compiler.out.size();
+    header.rootOffset = rootAt;
+    std::memcpy(&compiler.out[headerAt], &header, sizeof header);
+
+    return std::move(compiler.out);
+}
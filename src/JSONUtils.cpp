@@ -1,42 +1,94 @@
 #include "../include/JSONUtils.h"
+#include "../include/StringScan.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 
-std::string JSONUtils::escapeString(const std::string& s) {
-    std::ostringstream out;
+std::string JSONUtils::escapeString(std::string_view s) {
+    std::string out;
+    appendEscaped(out, s);
+    return out;
+}
+
+std::string JSONUtils::formatNumber(double value) {
+    std::string out;
+    appendNumber(out, value);
+    return out;
+}
+
+std::string JSONUtils::formatInteger(int64_t value) {
+    std::string out;
+    appendInteger(out, value);
+    return out;
+}
+
+void JSONUtils::appendEscaped(std::string& out, std::string_view s) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    // Clean runs between escapes are found with a vector scan and
+    // appended in one go; a string with nothing to escape is a single
+    // scan plus a single append
+    const char* data = s.data();
+    size_t runStart = 0;
+    for (size_t i = StringScan::findEscape(data, 0, s.size()); i < s.size();
+         i = StringScan::findEscape(data, i, s.size())) {
+        out.append(data + runStart, i - runStart);
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        runStart = ++i;
 
-    for (char c : s) {
         switch (c) {
-            case '\"': out << "\\\""; break;
-            case '\\': out << "\\\\"; break;
-            case '\b': out << "\\b";  break;
-            case '\f': out << "\\f";  break;
-            case '\n': out << "\\n";  break;
-            case '\r': out << "\\r";  break;
-            case '\t': out << "\\t";  break;
+            case '\"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
 
             default:
-                if (static_cast<unsigned char>(c) < 0x20) {
-                    out << "\\u"
-                        << std::uppercase << std::hex
-                        << std::setw(4) << std::setfill('0')
-                        << (int)c;
-                } else {
-                    out << c;
-                }
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
         }
     }
-    return out.str();
+    out.append(data + runStart, s.size() - runStart);
 }
 
-std::string JSONUtils::formatNumber(double value) {
-    std::ostringstream ss;
-    
-    // Check if it's an integer value
-    if (value == static_cast<long long>(value)) {
-        ss << static_cast<long long>(value);
-    } else {
-        // Use high precision for floating point
-        ss << std::setprecision(17) << value;
+// Shortest text that parses back to exactly the same double
+// (std::to_chars, Ryu-class), e.g. 0.1 -> "0.1" instead of the
+// setprecision(17) "0.10000000000000001".
+void JSONUtils::appendNumber(std::string& out, double value) {
+    // JSON has no NaN / Infinity
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+
+    // Integers that a double holds exactly (|v| < 2^53) take the integer
+    // path; larger or fractional values never go through a cast that
+    // could overflow. -0 keeps its sign via the double path.
+    if (std::fabs(value) < 9007199254740992.0 && std::trunc(value) == value
+        && !(value == 0 && std::signbit(value))) {
+        appendInteger(out, static_cast<int64_t>(value));
+        return;
     }
-    
-    return ss.str();
+
+    char buf[32];
+#if defined(__cpp_lib_to_chars)
+    char* end = std::to_chars(buf, buf + sizeof buf, value).ptr;
+#else
+    // Older standard libraries: 17 significant digits always round-trip
+    char* end = buf + std::snprintf(buf, sizeof buf, "%.17g", value);
+#endif
+
+    out.append(buf, size_t(end - buf));
+}
+
+// Integer to_chars writes two digits per step from a lookup table, with
+// no floating-point work at all
+void JSONUtils::appendInteger(std::string& out, int64_t value) {
+    char buf[24];
+    char* end = std::to_chars(buf, buf + sizeof buf, value).ptr;
+    out.append(buf, size_t(end - buf));
 }
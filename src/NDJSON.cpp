@@ -0,0 +1,136 @@
+#include "../include/NDJSON.h"
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
+#include <vector>
+
+namespace {
+
+struct Chunk {
+    size_t begin;
+    size_t end;
+    int firstLine;
+};
+
+struct ChunkResult {
+    std::string output;
+    size_t records = 0;
+    std::exception_ptr error;   // first failing record of the chunk
+};
+
+size_t countNewlines(const char* data, size_t length) {
+    size_t count = 0;
+    const char* end = data + length;
+    for (const char* nl = static_cast<const char*>(std::memchr(data, '\n', length));
+         nl; nl = static_cast<const char*>(std::memchr(nl + 1, '\n', end - nl - 1)))
+        count++;
+    return count;
+}
+
+bool isBlank(std::string_view line) {
+    for (char c : line) {
+        if (c != ' ' && c != '\t' && c != '\r')
+            return false;
+    }
+    return true;
+}
+
+ChunkResult processChunk(std::string_view text, const Chunk& chunk, const NDJSON::RecordFn& process) {
+    ChunkResult result;
+
+    ValueSpan record;
+    record.line = chunk.firstLine;
+
+    size_t pos = chunk.begin;
+    while (pos < chunk.end) {
+        const void* nl = std::memchr(text.data() + pos, '\n', chunk.end - pos);
+        size_t lineEnd = nl ? size_t(static_cast<const char*>(nl) - text.data()) : chunk.end;
+
+        if (!isBlank(text.substr(pos, lineEnd - pos))) {
+            record.begin = pos;
+            record.end = lineEnd;
+            record.lineStart = pos;
+            try {
+                process(record, result.output);
+            } catch (...) {
+                result.error = std::current_exception();
+                return result;
+            }
+            result.records++;
+        }
+
+        record.line++;
+        pos = lineEnd + 1;
+    }
+    return result;
+}
+
+} // namespace
+
+size_t NDJSON::forEachRecord(std::string_view text, ThreadPool& pool,
+                             const RecordFn& process, const SinkFn& sink) {
+    // 1) Cut into chunks that end right after a newline
+    std::vector<Chunk> chunks;
+    for (size_t start = 0; start < text.size(); ) {
+        size_t end = text.size();
+        if (text.size() - start > chunkBytes) {
+            const void* nl = std::memchr(text.data() + start + chunkBytes, '\n',
+                                         text.size() - start - chunkBytes);
+            if (nl)
+                end = size_t(static_cast<const char*>(nl) - text.data()) + 1;
+        }
+        chunks.push_back(Chunk{start, end, 1});
+        start = end;
+    }
+
+    // 2) Count lines per chunk in parallel, then assign global line numbers
+    {
+        std::vector<std::future<size_t>> counts;
+        for (const Chunk& c : chunks)
+            counts.push_back(pool.submit([text, c] { return countNewlines(text.data() + c.begin, c.end - c.begin); }));
+
+        int line = 1;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            chunks[i].firstLine = line;
+            line += int(counts[i].get());
+        }
+    }
+
+    // 3) Process chunks; only a couple per worker are in flight at once,
+    // so the output of a huge file is never buffered as a whole
+    std::deque<std::future<ChunkResult>> inFlight;
+    size_t next = 0;
+    size_t window = pool.size() * 2;
+    size_t records = 0;
+
+    auto submitNext = [&] {
+        Chunk c = chunks[next++];
+        inFlight.push_back(pool.submit([text, c, &process] { return processChunk(text, c, process); }));
+    };
+
+    try {
+        while (next < chunks.size() && inFlight.size() < window)
+            submitNext();
+
+        while (!inFlight.empty()) {
+            ChunkResult result = inFlight.front().get();
+            inFlight.pop_front();
+
+            records += result.records;
+            sink(result.output);
+            if (result.error)
+                std::rethrow_exception(result.error);
+
+            if (next < chunks.size())
+                submitNext();
+        }
+    } catch (...) {
+        // Queued tasks still reference `process`; let them finish first
+        for (auto& f : inFlight)
+            f.wait();
+        throw;
+    }
+
+    return records;
+}
@@ -0,0 +1,103 @@
+#include "../include/ParallelParser.h"
+#include "../include/JSONCursor.h"
+#include <future>
+#include <vector>
+
+namespace {
+
+// Consecutive root-array elements parsed by one task
+struct Range {
+    size_t first;
+    size_t count;
+};
+
+// Splits the root array into ranges; fewer than two means "go serial"
+std::vector<Range> splitRootArray(std::string_view text, std::vector<ValueSpan>& elements) {
+    std::vector<Range> ranges;
+    if (!JSONCursor(text).rootElements(elements))
+        return ranges;
+
+    size_t first = 0;
+    for (size_t i = 0; i < elements.size(); i++) {
+        bool full = elements[i].end - elements[first].begin >= ParallelParser::rangeBytes;
+        if (full || i + 1 == elements.size()) {
+            ranges.push_back(Range{first, i + 1 - first});
+            first = i + 1;
+        }
+    }
+    return ranges;
+}
+
+// Waits for every task first (they reference the caller's element list),
+// then returns the results in order; the first failure in input order
+// is rethrown
+template <class T>
+std::vector<T> collect(std::vector<std::future<T>>& futures) {
+    for (auto& f : futures)
+        f.wait();
+
+    std::vector<T> results;
+    results.reserve(futures.size());
+    for (auto& f : futures)
+        results.push_back(f.get());
+    return results;
+}
+
+} // namespace
+
+JSONValue ParallelParser::parse(std::string_view text, ThreadPool& pool) {
+    std::vector<ValueSpan> elements;
+    std::vector<Range> ranges = splitRootArray(text, elements);
+
+    if (ranges.size() < 2) {
+        Tokenizer tokenizer(text);
+        tokenizer.enableStructuralIndex();
+        return Parser(tokenizer).parse();
+    }
+
+    std::vector<std::future<JSONArray>> futures;
+    for (const Range& r : ranges) {
+        futures.push_back(pool.submit([text, &elements, r] {
+            JSONArray part;
+            part.reserve(r.count);
+            KeyTable keys;   // shared by the range's elements
+            for (size_t i = r.first; i < r.first + r.count; i++) {
+                const ValueSpan& e = elements[i];
+                Tokenizer tokenizer(text.substr(0, e.end));
+                tokenizer.seek(e.begin, e.line, e.lineStart);
+                JSONValueBuilder builder(&keys);
+                Parser(tokenizer).parse(builder);
+                part.push_back(std::make_shared<JSONValue>(builder.takeResult()));
+            }
+            return part;
+        }));
+    }
+
+    JSONArray root;
+    root.reserve(elements.size());
+    for (JSONArray& part : collect(futures)) {
+        for (auto& value : part)
+            root.push_back(std::move(value));
+    }
+    return JSONValue(std::move(root));
+}
+
+JSONDocument ParallelParser::parse(std::shared_ptr<const MappedFile> file, ThreadPool& pool) {
+    std::string_view text = file->view();
+
+    std::vector<ValueSpan> elements;
+    std::vector<Range> ranges = splitRootArray(text, elements);
+
+    if (ranges.size() < 2)
+        return JSONDocument::parse(std::move(file));
+
+    std::vector<std::future<JSONDocument>> futures;
+    for (const Range& r : ranges) {
+        futures.push_back(pool.submit([&file, text, &elements, r] {
+            return JSONDocument::buildElements(file, text, &elements[r.first], r.count);
+        }));
+    }
+
+    std::vector<JSONDocument> parts = collect(futures);
+    return JSONDocument::join(std::move(file), text, std::move(parts));
+}
@@ -0,0 +1,260 @@
+#include "../include/PushParser.h"
+#include "../include/StringScan.h"
+#include "../include/tokenizer.h"
+#include <cstring>
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+// Stretches shorter than this are lexed without the structural index
+constexpr size_t indexThreshold = 4096;
+
+// Bytes that end a number or keyword
+bool isDelimiter(char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n': case '\r':
+        case '{': case '}': case '[': case ']': case ':': case ',': case '"':
+            return true;
+    }
+    return false;
+}
+
+// One past the closing quote of a string whose body continues at
+// `from`, or npos when the text ends first. `escaped` carries a
+// trailing backslash from one chunk into the next.
+size_t stringEnd(std::string_view text, size_t from, bool& escaped) {
+    size_t i = from;
+    if (escaped) {
+        if (i >= text.size())
+            return npos;
+        escaped = false;
+        i++;
+    }
+    for (;;) {
+        size_t stop = StringScan::findQuoteOrBackslash(text.data(), i, text.size());
+        if (stop >= text.size())
+            return npos;
+        if (text[stop] == '"')
+            return stop + 1;
+        if (stop + 1 >= text.size()) {
+            escaped = true;
+            return npos;
+        }
+        i = stop + 2;
+    }
+}
+
+// Offset of the first delimiter at or after `from`, or npos
+size_t scalarEnd(std::string_view text, size_t from) {
+    for (size_t i = from; i < text.size(); i++) {
+        if (isDelimiter(text[i]))
+            return i;
+    }
+    return npos;
+}
+
+// Where the unfinished token at the end of `text` starts (text.size()
+// when the text ends between tokens). Strings are followed from quote
+// to quote so brackets and quotes inside them are not mistaken for
+// structure; a chunk ending inside one reports it through `inString`.
+size_t completeUpTo(std::string_view text, size_t from, bool& inString, bool& escaped) {
+    size_t i = from;
+    while (i < text.size()) {
+        const void* quote = std::memchr(text.data() + i, '"', text.size() - i);
+        if (!quote)
+            break;
+
+        size_t open = size_t(static_cast<const char*>(quote) - text.data());
+        bool escape = false;
+        size_t close = stringEnd(text, open + 1, escape);
+        if (close == npos) {
+            inString = true;
+            escaped = escape;
+            return open;
+        }
+        i = close;
+    }
+
+    // A number or keyword running into the end may continue in the
+    // next chunk
+    inString = false;
+    escaped = false;
+    size_t end = text.size();
+    while (end > i && !isDelimiter(text[end - 1]))
+        end--;
+    return end;
+}
+
+} // namespace
+
+PushParser::PushParser(JSONHandler& handler, std::function<void()> onValue)
+    : handler(handler), onValue(std::move(onValue)) {}
+
+void PushParser::feed(std::string_view chunk) {
+    size_t start = 0;
+
+    // Finish the token the previous chunk ended in
+    if (!pending.empty()) {
+        size_t end = pendingString ? stringEnd(chunk, 0, pendingEscape) : scalarEnd(chunk, 0);
+        if (end == npos) {
+            pending.append(chunk);
+            return;
+        }
+        pending.append(chunk.data(), end);
+        lex(pending, 0, pending.size());
+        pending.clear();
+        start = end;
+    }
+
+    size_t cut = completeUpTo(chunk, start, pendingString, pendingEscape);
+    lex(chunk, start, cut);
+    pending.assign(chunk.substr(cut));
+}
+
+void PushParser::finish() {
+    // A number or keyword is complete at the end of the input; a string
+    // still open is reported by the tokenizer as unterminated
+    if (!pending.empty()) {
+        lex(pending, 0, pending.size());
+        pending.clear();
+    }
+
+    if (!stack.empty() || (!onValue && values == 0))
+        throw JSONParseError("Unexpected end of input", line, column);
+}
+
+// Tokenizes text[from, to), which starts at (line, column) and ends
+// between tokens. The tokenizer's column is pos - lineStart + 1, so a
+// line start before `from` (wrapping below zero when the current line
+// began in an earlier chunk) keeps columns counting across chunks.
+void PushParser::lex(std::string_view text, size_t from, size_t to) {
+    if (from >= to)
+        return;
+
+    Tokenizer tokenizer(text.substr(0, to));
+    tokenizer.seek(from, line, from - size_t(column - 1));
+    if (to - from >= indexThreshold)
+        tokenizer.enableStructuralIndex();
+
+    Token t(TokenType::END_OF_FILE);
+    for (;;) {
+        tokenizer.nextToken(t);
+        if (t.type == TokenType::END_OF_FILE)
+            break;
+        token(t);
+    }
+
+    line = tokenizer.currentLine();
+    column = tokenizer.column();
+}
+
+void PushParser::token(Token& t) {
+    switch (expect) {
+        case Expect::Nothing:
+            unexpected(t, "Unexpected token after root value: ");
+
+        case Expect::ValueOrEnd:
+            if (t.type == TokenType::RBRACKET)
+                return close();
+            [[fallthrough]];
+
+        case Expect::Value:
+            if ((t.type == TokenType::LBRACE || t.type == TokenType::LBRACKET) && stack.size() >= maxDepth)
+                throw JSONParseError("Nesting deeper than " + std::to_string(maxDepth) + " levels", t.line, t.column);
+
+            switch (t.type) {
+                case TokenType::LBRACE:
+                    handler.startObject();
+                    stack.push_back(Frame{true});
+                    expect = Expect::KeyOrEnd;
+                    return;
+                case TokenType::LBRACKET:
+                    handler.startArray();
+                    stack.push_back(Frame{false});
+                    expect = Expect::ValueOrEnd;
+                    return;
+                case TokenType::STRING:
+                    handler.string(t.text());
+                    break;
+                case TokenType::NUMBER:
+                    if (t.integral)
+                        handler.integer(t.integer);
+                    else
+                        handler.number(t.number);
+                    break;
+                case TokenType::TRUE:
+                    handler.boolean(true);
+                    break;
+                case TokenType::FALSE:
+                    handler.boolean(false);
+                    break;
+                case TokenType::NUL:
+                    handler.null();
+                    break;
+                default:
+                    unexpected(t, "Unexpected token when parsing value: ");
+            }
+            return valueDone();
+
+        case Expect::KeyOrEnd:
+            if (t.type == TokenType::RBRACE)
+                return close();
+            [[fallthrough]];
+
+        case Expect::Key:
+            if (t.type != TokenType::STRING)
+                throw JSONParseError("Expected string as object key", t.line, t.column);
+            handler.key(t.text());
+            expect = Expect::Colon;
+            return;
+
+        case Expect::Colon:
+            if (t.type != TokenType::COLON)
+                unexpected(t, "Expected ':' after object key but found ");
+            expect = Expect::Value;
+            return;
+
+        case Expect::CommaOrEnd: {
+            bool object = stack.back().object;
+            if (t.type == TokenType::COMMA) {
+                expect = object ? Expect::Key : Expect::Value;
+                return;
+            }
+            if (t.type == (object ? TokenType::RBRACE : TokenType::RBRACKET))
+                return close();
+            throw JSONParseError(object ? "Expected ',' or '}' after object pair"
+                                        : "Expected ',' or ']' after array element", t.line, t.column);
+        }
+    }
+}
+
+void PushParser::close() {
+    Frame frame = stack.back();
+    stack.pop_back();
+    if (frame.object)
+        handler.endObject(frame.count);
+    else
+        handler.endArray(frame.count);
+    valueDone();
+}
+
+void PushParser::valueDone() {
+    if (!stack.empty()) {
+        stack.back().count++;
+        expect = Expect::CommaOrEnd;
+        return;
+    }
+
+    values++;
+    if (onValue) {
+        onValue();
+        expect = Expect::Value;
+    } else {
+        expect = Expect::Nothing;
+    }
+}
+
+void PushParser::unexpected(const Token& t, const char* message) {
+    throw JSONParseError(message + tokenTypeName(t.type), t.line, t.column);
+}
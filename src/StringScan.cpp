@@ -0,0 +1,110 @@
+#include "../include/StringScan.h"
+#include "../include/CPUFeatures.h"
+#include <cstdint>
+
+#if JSON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using FindFn = size_t (*)(const char* data, size_t from, size_t size);
+
+struct ByteTable {
+    bool match[256] = {};
+    ByteTable(bool controls) {
+        for (int c = 0; controls && c < 0x20; c++)
+            match[c] = true;
+        match[(unsigned char)'"'] = true;
+        match[(unsigned char)'\\'] = true;
+    }
+};
+
+const ByteTable quoteTable(false);
+const ByteTable escapeTable(true);
+
+inline size_t findScalar(const ByteTable& table, const char* data, size_t i, size_t size) {
+    while (i < size && !table.match[static_cast<unsigned char>(data[i])])
+        i++;
+    return i;
+}
+
+size_t findQuoteScalar(const char* data, size_t i, size_t size) {
+    return findScalar(quoteTable, data, i, size);
+}
+
+size_t findEscapeScalar(const char* data, size_t i, size_t size) {
+    return findScalar(escapeTable, data, i, size);
+}
+
+inline int lowestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+#if JSON_X86_SIMD
+
+// Control bytes are found as max(v, 0x1F) == 0x1F (unsigned compare)
+template <bool Controls>
+JSON_TARGET_SSE42 size_t findSSE42(const char* data, size_t i, size_t size) {
+    const __m128i control = _mm_set1_epi8(0x1F);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        if (Controls)
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(hit));
+        if (mask)
+            return i + lowestBit(mask);
+    }
+    return findScalar(Controls ? escapeTable : quoteTable, data, i, size);
+}
+
+template <bool Controls>
+JSON_TARGET_AVX2 size_t findAVX2(const char* data, size_t i, size_t size) {
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash));
+        if (Controls)
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(hit));
+        if (mask)
+            return i + lowestBit(mask);
+    }
+    return findScalar(Controls ? escapeTable : quoteTable, data, i, size);
+}
+
+#endif
+
+template <bool Controls>
+FindFn pick() {
+#if JSON_X86_SIMD
+    if (CPUFeatures::hasAVX2())  return findAVX2<Controls>;
+    if (CPUFeatures::hasSSE42()) return findSSE42<Controls>;
+#endif
+    return Controls ? findEscapeScalar : findQuoteScalar;
+}
+
+} // namespace
+
+size_t StringScan::findQuoteOrBackslash(const char* data, size_t from, size_t size) {
+    static const FindFn find = pick<false>();
+    return find(data, from, size);
+}
+
+size_t StringScan::findEscape(const char* data, size_t from, size_t size) {
+    static const FindFn find = pick<true>();
+    return find(data, from, size);
+}
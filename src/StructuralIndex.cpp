@@ -0,0 +1,245 @@
+#include "../include/StructuralIndex.h"
+#include "../include/CPUFeatures.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if JSON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t op = 0;          // { } [ ] : ,
+    uint64_t whitespace = 0;  // space, \t, \n, \r
+};
+
+using ClassifyFn = void (*)(const char* block, BlockMasks& masks);
+
+// ====================================================
+// Byte classification (the only ISA-specific part)
+// ====================================================
+void classifyScalar(const char* p, BlockMasks& m) {
+    m = BlockMasks();
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = uint64_t(1) << i;
+        switch (p[i]) {
+            case '"':  m.quote |= bit; break;
+            case '\\': m.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                m.op |= bit; break;
+            case ' ': case '\t': case '\n': case '\r':
+                m.whitespace |= bit; break;
+            default: break;
+        }
+    }
+}
+
+#if JSON_X86_SIMD
+
+// SSE4.2: PCMPESTRM matches every byte against a whole character set
+// in one instruction; quotes and backslashes use plain byte compares.
+JSON_TARGET_SSE42 void classifySSE42(const char* p, BlockMasks& m) {
+    const __m128i opSet = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i wsSet = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+
+    m = BlockMasks();
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        int shift = i * 16;
+        m.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+        m.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << shift;
+        m.op |= uint64_t(uint16_t(_mm_cvtsi128_si32(_mm_cmpestrm(opSet, 6, v, 16, mode)))) << shift;
+        m.whitespace |= uint64_t(uint16_t(_mm_cvtsi128_si32(_mm_cmpestrm(wsSet, 4, v, 16, mode)))) << shift;
+    }
+}
+
+JSON_TARGET_AVX2 void classifyAVX2(const char* p, BlockMasks& m) {
+    m = BlockMasks();
+    for (int i = 0; i < 2; i++) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 32));
+
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8(']'))));
+        op = _mm256_or_si256(op,
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+
+        int shift = i * 32;
+        m.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))))) << shift;
+        m.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))))) << shift;
+        m.op |= uint64_t(uint32_t(_mm256_movemask_epi8(op))) << shift;
+        m.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(ws))) << shift;
+    }
+}
+
+#endif
+
+// ====================================================
+// Block state machine (shared by all backends)
+// ====================================================
+struct ScanState {
+    uint64_t escapedCarry = 0;  // 1 if the first byte of the next block is escaped
+    uint64_t inString = 0;      // all-ones if the previous block ended inside a string
+    uint64_t scalarCarry = 0;   // 1 if the previous block ended inside a scalar
+};
+
+inline int lowestBit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+// Bits of characters preceded by an unescaped backslash.
+// Backslashes are rare, so a loop over them beats a branch-free formula.
+inline uint64_t findEscaped(uint64_t backslash, ScanState& s) {
+    uint64_t escaped = s.escapedCarry;
+    s.escapedCarry = 0;
+
+    while (backslash) {
+        int i = lowestBit(backslash);
+        backslash &= backslash - 1;
+        uint64_t bit = uint64_t(1) << i;
+        if (escaped & bit)
+            continue;            // this backslash is itself escaped
+        if (i == 63)
+            s.escapedCarry = 1;  // escapes the first byte of the next block
+        else
+            escaped |= bit << 1;
+    }
+    return escaped;
+}
+
+// Running XOR: bit i = parity of quote bits 0..i (1 = inside a string)
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+inline uint64_t tokenStarts(const BlockMasks& m, ScanState& s) {
+    uint64_t escaped = findEscaped(m.backslash, s);
+    uint64_t quotes = m.quote & ~escaped;
+
+    // Opening quote and string body are set, closing quote is clear
+    uint64_t inString = prefixXor(quotes) ^ s.inString;
+    s.inString = uint64_t(0) - (inString >> 63);
+
+    uint64_t outside = ~inString;
+    uint64_t op = m.op & outside;
+    uint64_t openQuotes = quotes & inString;
+
+    // Scalar bytes: anything outside strings that is not an operator,
+    // whitespace or a (closing) quote. Only the first byte of a run counts.
+    uint64_t scalar = outside & ~(m.op | m.whitespace | quotes);
+    uint64_t scalarStarts = scalar & ~((scalar << 1) | s.scalarCarry);
+    s.scalarCarry = scalar >> 63;
+
+    return op | openQuotes | scalarStarts;
+}
+
+ClassifyFn classifierFor(StructuralIndex::Backend backend) {
+    switch (backend) {
+#if JSON_X86_SIMD
+        case StructuralIndex::Backend::AVX2:  return classifyAVX2;
+        case StructuralIndex::Backend::SSE42: return classifySSE42;
+#endif
+        default: return classifyScalar;
+    }
+}
+
+} // namespace
+
+bool StructuralIndex::isSupported(Backend backend) {
+    switch (backend) {
+        case Backend::Auto:
+        case Backend::Scalar: return true;
+        case Backend::SSE42:  return JSON_X86_SIMD && CPUFeatures::hasSSE42();
+        case Backend::AVX2:   return JSON_X86_SIMD && CPUFeatures::hasAVX2();
+    }
+    return false;
+}
+
+StructuralIndex::Backend StructuralIndex::bestBackend() {
+    if (isSupported(Backend::AVX2))  return Backend::AVX2;
+    if (isSupported(Backend::SSE42)) return Backend::SSE42;
+    return Backend::Scalar;
+}
+
+const char* StructuralIndex::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::Auto:   return backendName(bestBackend());
+        case Backend::Scalar: return "scalar";
+        case Backend::SSE42:  return "sse4.2";
+        case Backend::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+std::vector<uint32_t> StructuralIndex::build(const char* data, size_t length, Backend backend) {
+    if (length >= std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("Input too large for structural index (limit is 4 GB)");
+
+    if (backend == Backend::Auto)
+        backend = bestBackend();
+    if (!isSupported(backend))
+        throw std::runtime_error(std::string("CPU does not support the ")
+            + backendName(backend) + " structural index backend");
+
+    ClassifyFn classify = classifierFor(backend);
+
+    std::vector<uint32_t> positions;
+    positions.reserve(length / 6 + 16);
+
+    ScanState state;
+    BlockMasks masks;
+    size_t offset = 0;
+
+    auto emit = [&](uint64_t bits) {
+        while (bits) {
+            positions.push_back(uint32_t(offset + lowestBit(bits)));
+            bits &= bits - 1;
+        }
+    };
+
+    for (; offset + 64 <= length; offset += 64) {
+        classify(data + offset, masks);
+        emit(tokenStarts(masks, state));
+    }
+
+    // Last partial block: pad with spaces so padding never starts a token
+    if (offset < length) {
+        char tail[64];
+        std::memset(tail, ' ', sizeof(tail));
+        std::memcpy(tail, data + offset, length - offset);
+        classify(tail, masks);
+        emit(tokenStarts(masks, state));
+    }
+
+    return positions;
+}
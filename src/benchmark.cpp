@@ -1,9 +1,12 @@
 #include <iostream>
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <vector>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
+#include <utility>
 
 #include "../include/FileUtils.h"
 #include "../include/tokenizer.h"
@@ -12,153 +15,335 @@
 
 using namespace std::chrono;
 
+// ===============================================================
+// Every file is run `warmup` times untimed, then `iterations` times
+// with each phase timed on its own:
+//
+//   read       file → string
+//   tokenize   a lexing-only pass over the text (tokens discarded)
+//   parse      the CLI's single pass: lexing + grammar + JSONValue tree
+//   serialize  compact output of the tree
+//   teardown   freeing the tree
+//
+// Phases are summarized over the iterations (min / median / p90 / p99 /
+// mean / stddev), so a change can be judged against the run-to-run
+// spread rather than one sample.
+// ===============================================================
+enum Phase { Read, Tokenize, Parse, Serialize, Teardown, PhaseCount };
+const char* const phaseNames[PhaseCount] = {"read", "tokenize", "parse", "serialize", "teardown"};
+
+struct Stats {
+    double min = 0, median = 0, p90 = 0, p99 = 0, mean = 0, stddev = 0;
+};
+
 struct BenchmarkResult {
     std::string filename;
     size_t fileSize;
-    double parseTimeMs;
-    double serializeTimeMs;
-    double totalTimeMs;
-    double throughputMBps;
+    Stats phases[PhaseCount];
+    Stats processing;          // parse + serialize, per iteration
+    double throughputMBps;     // file size / median processing time
     size_t memoryUsed;
     int nestingDepth;
 };
 
-// Calculate nesting depth
-int calculateDepth(const JSONValue& value, int currentDepth = 0) {
-    int maxDepth = currentDepth;
-    
-    if (value.isArray()) {
-        for (const auto& elem : value.asArray()) {
-            int depth = calculateDepth(*elem, currentDepth + 1);
-            maxDepth = std::max(maxDepth, depth);
-        }
-    } else if (value.isObject()) {
-        for (const auto& [key, val] : value.asObject()) {
-            int depth = calculateDepth(*val, currentDepth + 1);
-            maxDepth = std::max(maxDepth, depth);
+struct Options {
+    int warmup = 3;
+    int iterations = 20;
+    std::string jsonPath;      // machine-readable results, when set
+};
+
+// Calculate nesting depth (worklist of node + depth, no recursion, so
+// the deep-nesting files cannot overflow the stack)
+int calculateDepth(const JSONValue& value) {
+    int maxDepth = 0;
+    std::vector<std::pair<const JSONValue*, int>> pending{{&value, 0}};
+
+    while (!pending.empty()) {
+        auto [node, depth] = pending.back();
+        pending.pop_back();
+        maxDepth = std::max(maxDepth, depth);
+
+        if (node->isArray()) {
+            for (const auto& elem : node->asArray())
+                pending.emplace_back(elem.get(), depth + 1);
+        } else if (node->isObject()) {
+            for (const auto& [key, val] : node->asObject())
+                pending.emplace_back(val.get(), depth + 1);
         }
     }
-    
+
     return maxDepth;
 }
 
 // Estimate memory usage (rough approximation)
 size_t estimateMemory(const JSONValue& value) {
-    size_t total = sizeof(JSONValue);
-    
-    if (value.isString()) {
-        total += value.asString().capacity();
-    } else if (value.isArray()) {
-        const auto& arr = value.asArray();
-        total += arr.capacity() * sizeof(std::shared_ptr<JSONValue>);
-        for (const auto& elem : arr) {
-            total += estimateMemory(*elem);
-        }
-    } else if (value.isObject()) {
-        const auto& obj = value.asObject();
-        total += obj.size() * (sizeof(std::string) + sizeof(std::shared_ptr<JSONValue>) + 32); // hash overhead
-        for (const auto& [key, val] : obj) {
-            total += key.capacity();
-            total += estimateMemory(*val);
+    size_t total = 0;
+    std::vector<const JSONValue*> pending{&value};
+
+    while (!pending.empty()) {
+        const JSONValue& node = *pending.back();
+        pending.pop_back();
+        total += sizeof(JSONValue);
+
+        if (node.isString()) {
+            total += node.asString().capacity();
+        } else if (node.isArray()) {
+            const auto& arr = node.asArray();
+            total += arr.capacity() * sizeof(std::shared_ptr<JSONValue>);
+            for (const auto& elem : arr)
+                pending.push_back(elem.get());
+        } else if (node.isObject()) {
+            const auto& obj = node.asObject();
+            // Key text is interned (shared by the whole document), so only
+            // the per-member handle is counted
+            total += obj.size() * (sizeof(JSONKey) + sizeof(std::shared_ptr<JSONValue>) + 32); // hash overhead
+            for (const auto& [key, val] : obj)
+                pending.push_back(val.get());
         }
     }
-    
+
     return total;
 }
 
-BenchmarkResult benchmarkFile(const std::string& filepath) {
-    BenchmarkResult result;
-    result.filename = filepath;
-    
-    // Read file
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = size_t(std::ceil(p / 100.0 * double(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+Stats summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    Stats s;
+    s.min = samples.front();
+    s.median = percentile(samples, 50);
+    s.p90 = percentile(samples, 90);
+    s.p99 = percentile(samples, 99);
+
+    double sum = 0;
+    for (double x : samples)
+        sum += x;
+    s.mean = sum / double(samples.size());
+
+    double squares = 0;
+    for (double x : samples)
+        squares += (x - s.mean) * (x - s.mean);
+    s.stddev = samples.size() > 1 ? std::sqrt(squares / double(samples.size() - 1)) : 0;
+    return s;
+}
+
+double elapsedMs(steady_clock::time_point start) {
+    return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+// One timed pass through every phase; the times go into `samples`
+void runOnce(const std::string& filepath, std::vector<double> (&samples)[PhaseCount], JSONValue* keep = nullptr) {
+    auto start = steady_clock::now();
     std::string content = FileUtils::readFile(filepath);
-    result.fileSize = content.size();
-    
-    // Benchmark parsing
-    auto parseStart = high_resolution_clock::now();
-    
+    samples[Read].push_back(elapsedMs(start));
+
+    start = steady_clock::now();
+    {
+        Tokenizer tokenizer(content);
+        tokenizer.enableStructuralIndex();
+        Token token(TokenType::END_OF_FILE);
+        do {
+            tokenizer.nextToken(token);
+        } while (token.type != TokenType::END_OF_FILE);
+    }
+    samples[Tokenize].push_back(elapsedMs(start));
+
+    start = steady_clock::now();
     Tokenizer tokenizer(content);
-    std::vector<Token> tokens = tokenizer.tokenize();
-    
-    Parser parser(tokens);
-    JSONValue root = parser.parse();
-    
-    auto parseEnd = high_resolution_clock::now();
-    result.parseTimeMs = duration_cast<microseconds>(parseEnd - parseStart).count() / 1000.0;
-    
-    // Calculate depth and memory
+    tokenizer.enableStructuralIndex();
+    JSONValue root = Parser(tokenizer).parse();
+    samples[Parse].push_back(elapsedMs(start));
+
+    start = steady_clock::now();
+    std::string serialized = JSONSerializer::serializeCompact(root);
+    samples[Serialize].push_back(elapsedMs(start));
+
+    if (keep) {
+        *keep = std::move(root);
+        return;
+    }
+
+    start = steady_clock::now();
+    root = JSONValue(nullptr);
+    samples[Teardown].push_back(elapsedMs(start));
+}
+
+BenchmarkResult benchmarkFile(const std::string& filepath, const Options& options) {
+    BenchmarkResult result;
+    result.filename = filepath;
+
+    // Warmup: page cache, allocator and branch predictors settle; the
+    // last warmup run's tree is kept for the structural statistics
+    std::vector<double> samples[PhaseCount];
+    JSONValue root;
+    for (int i = 0; i < options.warmup; i++)
+        runOnce(filepath, samples, i + 1 == options.warmup ? &root : nullptr);
+    if (options.warmup == 0)
+        runOnce(filepath, samples, &root);
+
+    result.fileSize = FileUtils::readFile(filepath).size();
     result.nestingDepth = calculateDepth(root);
     result.memoryUsed = estimateMemory(root);
-    
-    // Benchmark serialization
-    auto serializeStart = high_resolution_clock::now();
-    std::string serialized = JSONSerializer::serializeCompact(root);
-    auto serializeEnd = high_resolution_clock::now();
-    result.serializeTimeMs = duration_cast<microseconds>(serializeEnd - serializeStart).count() / 1000.0;
-    
-    result.totalTimeMs = result.parseTimeMs + result.serializeTimeMs;
-    result.throughputMBps = (result.fileSize / (1024.0 * 1024.0)) / (result.totalTimeMs / 1000.0);
-    
+    root = JSONValue(nullptr);
+
+    for (auto& phase : samples)
+        phase.clear();
+    for (int i = 0; i < options.iterations; i++)
+        runOnce(filepath, samples);
+
+    std::vector<double> processing;
+    for (size_t i = 0; i < samples[Parse].size(); i++)
+        processing.push_back(samples[Parse][i] + samples[Serialize][i]);
+
+    for (int p = 0; p < PhaseCount; p++)
+        result.phases[p] = summarize(samples[p]);
+    result.processing = summarize(processing);
+    result.throughputMBps = (result.fileSize / (1024.0 * 1024.0)) / (result.processing.median / 1000.0);
+
     return result;
 }
 
-void printResults(const std::vector<BenchmarkResult>& results) {
+void printResults(const std::vector<BenchmarkResult>& results, const Options& options) {
     std::cout << "\n========================================\n";
     std::cout << "       JSON PARSER BENCHMARK RESULTS\n";
-    std::cout << "========================================\n\n";
-    
+    std::cout << "========================================\n";
+    std::cout << "Warmup: " << options.warmup << "   Iterations: " << options.iterations
+              << "   (times in ms)\n\n";
+
     double totalSize = 0;
     double totalTime = 0;
-    
+
     for (const auto& r : results) {
         std::cout << "File: " << r.filename << "\n";
-        std::cout << "  Size: " << std::fixed << std::setprecision(2) 
+        std::cout << "  Size: " << std::fixed << std::setprecision(2)
                   << (r.fileSize / 1024.0) << " KB\n";
-        std::cout << "  Parse Time: " << std::setprecision(3) << r.parseTimeMs << " ms\n";
-        std::cout << "  Serialize Time: " << r.serializeTimeMs << " ms\n";
-        std::cout << "  Total Time: " << r.totalTimeMs << " ms\n";
-        std::cout << "  Throughput: " << std::setprecision(2) << r.throughputMBps << " MB/s\n";
+
+        std::cout << "  " << std::left << std::setw(11) << "Phase" << std::right;
+        for (const char* column : {"min", "median", "p90", "p99", "stddev"})
+            std::cout << std::setw(11) << column;
+        std::cout << "\n";
+
+        auto row = [](const char* name, const Stats& s) {
+            std::cout << "  " << std::left << std::setw(11) << name << std::right << std::setprecision(3);
+            for (double v : {s.min, s.median, s.p90, s.p99, s.stddev})
+                std::cout << std::setw(11) << v;
+            std::cout << "  (±" << std::setprecision(1)
+                      << (s.mean > 0 ? 100.0 * s.stddev / s.mean : 0.0) << "%)\n";
+        };
+        for (int p = 0; p < PhaseCount; p++)
+            row(phaseNames[p], r.phases[p]);
+        row("parse+ser", r.processing);
+
+        std::cout << "  Throughput: " << std::setprecision(2) << r.throughputMBps
+                  << " MB/s (median parse + serialize)\n";
         std::cout << "  Memory Used: " << (r.memoryUsed / 1024.0) << " KB\n";
-        std::cout << "  Memory Overhead: " << std::setprecision(1) 
+        std::cout << "  Memory Overhead: " << std::setprecision(1)
                   << (r.memoryUsed / (double)r.fileSize) << "x\n";
         std::cout << "  Nesting Depth: " << r.nestingDepth << "\n\n";
-        
+
         totalSize += r.fileSize;
-        totalTime += r.totalTimeMs;
+        totalTime += r.processing.median;
     }
-    
+
     std::cout << "========================================\n";
     std::cout << "AGGREGATE STATISTICS:\n";
-    std::cout << "  Total Data Processed: " << std::setprecision(2) 
+    std::cout << "  Total Data Processed: " << std::setprecision(2)
               << (totalSize / (1024.0 * 1024.0)) << " MB\n";
-    std::cout << "  Total Time: " << std::setprecision(3) << totalTime << " ms\n";
-    std::cout << "  Average Throughput: " << std::setprecision(2) 
+    std::cout << "  Total Time: " << std::setprecision(3) << totalTime << " ms (sum of medians)\n";
+    std::cout << "  Average Throughput: " << std::setprecision(2)
               << (totalSize / (1024.0 * 1024.0)) / (totalTime / 1000.0) << " MB/s\n";
     std::cout << "========================================\n\n";
 }
 
+// The same numbers as JSON, for scripts comparing runs
+void writeJSON(const std::vector<BenchmarkResult>& results, const Options& options) {
+    auto stats = [](const Stats& s) {
+        JSONValue v = JSONObject();
+        v["min"] = s.min;
+        v["median"] = s.median;
+        v["p90"] = s.p90;
+        v["p99"] = s.p99;
+        v["mean"] = s.mean;
+        v["stddev"] = s.stddev;
+        return v;
+    };
+
+    JSONArray files;
+    for (const auto& r : results) {
+        JSONValue file = JSONObject();
+        file["file"] = r.filename;
+        file["bytes"] = int64_t(r.fileSize);
+        file["nestingDepth"] = int64_t(r.nestingDepth);
+        file["memoryBytes"] = int64_t(r.memoryUsed);
+        JSONValue phases = JSONObject();
+        for (int p = 0; p < PhaseCount; p++)
+            phases[phaseNames[p]] = stats(r.phases[p]);
+        phases["parse+serialize"] = stats(r.processing);
+        file["phasesMs"] = std::move(phases);
+        file["throughputMBps"] = r.throughputMBps;
+        files.push_back(std::make_shared<JSONValue>(std::move(file)));
+    }
+
+    JSONValue report = JSONObject();
+    report["warmup"] = int64_t(options.warmup);
+    report["iterations"] = int64_t(options.iterations);
+    report["files"] = std::move(files);
+
+    FileUtils::writeFile(options.jsonPath, JSONSerializer::serialize(report) + "\n");
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <json_file1> [json_file2] ...\n";
+    // Options may appear anywhere among the files
+    Options options;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--warmup" || arg == "--iterations") && i + 1 < argc) {
+            std::string value = argv[++i];
+            int n = -1;
+            try { size_t used = 0; n = std::stoi(value, &used); if (used != value.size()) n = -1; } catch (...) {}
+            if (n < 0 || (arg == "--iterations" && n == 0)) {
+                std::cerr << "Invalid " << arg << ": " << value << "\n";
+                return 1;
+            }
+            (arg == "--warmup" ? options.warmup : options.iterations) = n;
+        }
+        else if (arg == "--json" && i + 1 < argc)
+            options.jsonPath = argv[++i];
+        else
+            files.push_back(arg);
+    }
+
+    if (files.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--warmup N] [--iterations N] [--json results.json]"
+                  << " <json_file1> [json_file2] ...\n";
         return 1;
     }
-    
+
     std::vector<BenchmarkResult> results;
-    
-    for (int i = 1; i < argc; i++) {
+
+    for (const auto& file : files) {
         try {
-            std::cout << "Benchmarking: " << argv[i] << " ... " << std::flush;
-            auto result = benchmarkFile(argv[i]);
+            std::cout << "Benchmarking: " << file << " ... " << std::flush;
+            auto result = benchmarkFile(file, options);
             results.push_back(result);
             std::cout << "✓\n";
         } catch (const std::exception& e) {
             std::cerr << "✗ Error: " << e.what() << "\n";
         }
     }
-    
+
     if (!results.empty()) {
-        printResults(results);
+        printResults(results, options);
+        if (!options.jsonPath.empty()) {
+            writeJSON(results, options);
+            std::cout << "✔ JSON results written to: " << options.jsonPath << "\n";
+        }
     }
-    
+
     return 0;
 }
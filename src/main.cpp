@@ -1,16 +1,35 @@
 #include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <functional>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
 
+#include "../include/DocumentCache.h"
 #include "../include/FileUtils.h"
 #include "../include/token.h"
 #include "../include/tokenizer.h"
 #include "../include/parser.h"
+#include "../include/JSONDocument.h"
+#include "../include/JSONCursor.h"
 #include "../include/JSONSerializer.h"
-#include "../include/JSONPrinter.h"
+#include "../include/JSONWriter.h"
+#include "../include/JSONprinter.h"
 #include "../include/JSONPath.h"
 #include "../include/JSONNavigator.h"
+#include "../include/JSONPatch.h"
+#include "../include/JSONService.h"
+#include "../include/JSONSnapshot.h"
+#include "../include/NDJSON.h"
+#include "../include/ParallelParser.h"
+#include "../include/PushParser.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
 // ===============================================================
 // Print CLI Usage
@@ -23,36 +42,18 @@ void printUsage() {
     std::cout << "  json show <input.json>\n";
     std::cout << "  json get <input.json> <path>\n";
     std::cout << "  json set <input.json> <path> <value>\n";
-}
-
-// ===============================================================
-// Auto-detect JSON value type for "set"
-// ===============================================================
-JSONValue parseValueFromString(const std::string& s) {
-    if (s == "true")  return JSONValue(true);
-    if (s == "false") return JSONValue(false);
-    if (s == "null")  return JSONValue(nullptr);
-
-    bool isNum = true;
-    bool hasDot = false;
-
-    for (char c : s) {
-        if (c == '.') hasDot = true;
-        else if (!isdigit(c) && c != '-') isNum = false;
-    }
-
-    if (isNum) {
-        try {
-            double v = std::stod(s);
-            return JSONValue(v);
-        } catch (...) {}
-    }
-
-    // string with quotes → remove quotes
-    if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
-        return JSONValue(s.substr(1, s.size() - 2));
-
-    return JSONValue(s);
+    std::cout << "  json patch <input.json> <patch.json>   RFC 6902 operations, one write\n";
+    std::cout << "  json compile <input.json> <output.snap>\n";
+    std::cout << "  json serve [--port N]   HTTP API (POST /validate /pretty /minify /show /get /set)\n";
+    std::cout << "\nget, show, pretty and minify also read compiled snapshots directly.\n";
+    std::cout << "validate, pretty and minify read stdin when the input is '-'.\n";
+    std::cout << "\nOptions:\n";
+    std::cout << "  --ndjson   one JSON value per line (validate, pretty, minify, get),\n";
+    std::cout << "             processed on all cores, output in input order\n";
+    std::cout << "  --parallel parse the elements of a large root array on all cores\n";
+    std::cout << "             (pretty, minify, show, patch, compile)\n";
+    std::cout << "  --cache    keep a compiled snapshot of the file and reuse it while\n";
+    std::cout << "             the file is unchanged (get, show, pretty, minify)\n";
 }
 
 // ===============================================================
@@ -74,11 +75,231 @@ void printErrorContext(const std::string& source, int line, int column) {
     }
 }
 
+// ===============================================================
+// Snapshots answer the read-only commands; the others need JSON text
+// ===============================================================
+void rejectSnapshot(std::string_view bytes, const std::string& command) {
+    if (JSONSnapshot::isSnapshot(bytes))
+        throw std::runtime_error("'" + command + "' needs JSON text, but the input is a compiled snapshot");
+}
+
+// ===============================================================
+// Stream output through a JSONWriter to stdout (empty path) or to a
+// file. A file is written under a temporary name and renamed only when
+// `produce` succeeds, so an error leaves an existing output untouched.
+// Stdout is streamed as produced: on an error, what was written before
+// it has already gone out (the exit code is 1).
+// ===============================================================
+void writeOutput(const std::string& outputPath, const std::function<void(JSONWriter&)>& produce) {
+    if (outputPath.empty()) {
+        JSONWriter out([](std::string_view chunk) { std::cout.write(chunk.data(), chunk.size()); });
+        produce(out);
+        out.flush();
+        return;
+    }
+
+    FileUtils::writeReplacing(outputPath, [&produce](std::ostream& file) {
+        JSONWriter out([&file](std::string_view chunk) { file.write(chunk.data(), chunk.size()); });
+        produce(out);
+        out.flush();
+    });
+}
+
+// ===============================================================
+// NDJSON mode: every line is a separate document
+// ===============================================================
+int runNDJSON(const std::string& command, const std::string& inputPath, int argc, char* argv[]) {
+    auto file = FileUtils::mapFile(inputPath);
+    std::string_view text = file->view();
+    rejectSnapshot(text, command + " --ndjson");
+
+    NDJSON::RecordFn process;
+    std::vector<PathElement> parsedPath;
+    bool toStdout = argc >= 4 && std::string(argv[3]) == "stdout";
+    std::string suffix;
+
+    if (command == "validate") {
+        process = [text](const ValueSpan& record, std::string&) {
+            Tokenizer tokenizer(text.substr(0, record.end));
+            tokenizer.seek(record.begin, record.line, record.lineStart);
+            JSONHandler ignoreEvents;
+            Parser(tokenizer).parse(ignoreEvents);
+        };
+    }
+    else if (command == "pretty" || command == "minify") {
+        bool pretty = command == "pretty";
+        suffix = pretty ? "_pretty" : "_minified";
+        process = [text, pretty](const ValueSpan& record, std::string& out) {
+            Tokenizer tokenizer(text.substr(0, record.end));
+            tokenizer.seek(record.begin, record.line, record.lineStart);
+            JSONWriter writer(out);
+            SerializingHandler transcode(writer, pretty);
+            Parser(tokenizer).parse(transcode);
+            out += '\n';
+        };
+    }
+    else if (command == "get") {
+        if (argc < 4) {
+            std::cerr << "❌ Missing path.\n";
+            return 1;
+        }
+        parsedPath = JSONPath::parse(argv[3]);
+        toStdout = true;
+        process = [&file, text, &parsedPath](const ValueSpan& record, std::string& out) {
+            JSONCursor cursor(text.substr(record.begin, record.end - record.begin));
+            ValueSpan span;
+            try {
+                span = cursor.locate(parsedPath);
+            } catch (const JSONParseError& e) {
+                throw JSONParseError(e.what(), record.line, e.column);
+            } catch (const std::runtime_error& e) {
+                throw std::runtime_error(std::string(e.what()) + " (line " + std::to_string(record.line) + ")");
+            }
+
+            // The cursor saw only this line; shift its span back into the file
+            span.begin += record.begin;
+            span.end += record.begin;
+            span.line = record.line;
+            span.lineStart = record.lineStart;
+
+            JSONDocument doc = JSONDocument::parse(file, span);
+            JSONWriter writer(out);
+            JSONSerializer::writeCompact(doc.root(), writer);
+            out += '\n';
+        };
+    }
+    else {
+        std::cerr << "❌ --ndjson is not supported for: " << command << "\n";
+        return 1;
+    }
+
+    ThreadPool pool;
+
+    if (command == "validate") {
+        size_t records = NDJSON::forEachRecord(text, pool, process, [](const std::string&) {});
+        std::cout << "[OK] Valid NDJSON (" << records << " records)\n";
+        return 0;
+    }
+
+    std::string outputPath;
+    if (!toStdout) {
+        size_t dot = inputPath.find_last_of('.');
+        outputPath = dot == std::string::npos
+            ? inputPath + suffix
+            : inputPath.substr(0, dot) + suffix + inputPath.substr(dot);
+    }
+
+    writeOutput(outputPath, [&](JSONWriter& out) {
+        NDJSON::forEachRecord(text, pool, process, [&out](const std::string& chunk) { out.put(chunk); });
+    });
+
+    if (toStdout)
+        return 0;
+
+    std::cout << "✔ " << (command == "pretty" ? "Pretty" : "Minified")
+              << " NDJSON written to: " << outputPath << "\n";
+    return 0;
+}
+
+// ===============================================================
+// "-" as the input: stdin is parsed chunk by chunk as it arrives, so
+// only an unfinished token is held between reads (validate, pretty,
+// minify; the latter two stream their output to stdout)
+// ===============================================================
+int runStdin(const std::string& command) {
+    bool transcode = command == "pretty" || command == "minify";
+    if (!transcode && command != "validate")
+        throw std::runtime_error("'" + command + "' needs a file; only validate, pretty and minify read stdin");
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+
+    auto pump = [](PushParser& parser) {
+        std::vector<char> chunk(64 * 1024);
+        size_t got;
+        while ((got = std::fread(chunk.data(), 1, chunk.size(), stdin)) > 0)
+            parser.feed(std::string_view(chunk.data(), got));
+        parser.finish();
+    };
+
+    if (!transcode) {
+        JSONHandler ignoreEvents;
+        PushParser parser(ignoreEvents);
+        pump(parser);
+        std::cout << "[OK] Valid JSON\n";
+        return 0;
+    }
+
+    writeOutput("", [&](JSONWriter& out) {
+        SerializingHandler handler(out, command == "pretty");
+        PushParser parser(handler);
+        pump(parser);
+    });
+    std::cout << "\n";
+    return 0;
+}
+
+// ===============================================================
+// SERVE: the commands as an HTTP API (see JSONService)
+// ===============================================================
+int runServer(const std::string& portArg) {
+    int port = 5000;
+    if (!portArg.empty()) {
+        size_t used = 0;
+        try { port = std::stoi(portArg, &used); } catch (...) { used = 0; }
+        if (used != portArg.size() || port < 0 || port > 65535) {
+            std::cerr << "❌ Invalid port: " << portArg << "\n";
+            return 1;
+        }
+    }
+
+    ThreadPool pool;
+    HTTPServer server(JSONService::handle, pool);
+    uint16_t bound = server.listen("0.0.0.0", uint16_t(port));
+
+    std::cout << "✔ Serving on http://0.0.0.0:" << bound
+              << " (" << pool.size() << " worker threads)" << std::endl;
+    server.run();
+    return 0;
+}
+
 // ===============================================================
 // MAIN
 // ===============================================================
 int main(int argc, char* argv[]) {
 
+    // Options may appear anywhere; strip them so the positional
+    // arguments keep their usual indices
+    bool ndjson = false;
+    bool parallel = false;
+    bool cache = false;
+    std::string port;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ndjson")
+            ndjson = true;
+        else if (arg == "--parallel")
+            parallel = true;
+        else if (arg == "--cache")
+            cache = true;
+        else if (arg == "--port" && i + 1 < argc)
+            port = argv[++i];
+        else
+            argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    if (argc >= 2 && std::string(argv[1]) == "serve") {
+        try {
+            return runServer(port);
+        } catch (const std::exception& e) {
+            std::cerr << "\n❌ Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     if (argc < 3) {
         std::cerr << "❌ Error: Not enough arguments.\n\n";
         printUsage();
@@ -88,116 +309,246 @@ int main(int argc, char* argv[]) {
     std::string command = argv[1];
     std::string inputPath = argv[2];
 
-    try {
-        // ----------- Read JSON File -----------
-        std::string inputJSON = FileUtils::readFile(inputPath);
-
-        // ----------- Tokenize -----------
-        Tokenizer tokenizer(inputJSON);
-        std::vector<Token> tokens = tokenizer.tokenize();
+    // Input of the read-only commands: with --cache, the cached snapshot
+    // (compiled on the first run); the snapshot paths below take it
+    auto mapInput = [&](ThreadPool* pool) {
+        return cache ? DocumentCache().map(inputPath, pool) : FileUtils::mapFile(inputPath);
+    };
 
-        // ----------- Parse -----------
-        Parser parser(tokens);
-        JSONValue root = parser.parse();
+    try {
+        if (ndjson)
+            return runNDJSON(command, inputPath, argc, argv);
+        if (inputPath == "-")
+            return runStdin(command);
 
         // ===============================================================
-        // 1) PRETTY
+        // VALIDATE — SAX pass with a do-nothing handler, no tree is built
         // ===============================================================
-        if (command == "pretty") {
-            std::string pretty = JSONSerializer::serialize(root);
-            
-            if (argc >= 4 && std::string(argv[3]) == "stdout") {
-            std::cout << pretty << "\n";
-            return 0;
-            }
-            std::string outputPath =
-                inputPath.substr(0, inputPath.find_last_of('.')) + "_pretty.json";
+        if (command == "validate") {
+            auto file = FileUtils::mapFile(inputPath);
+            rejectSnapshot(file->view(), command);
+            Tokenizer tokenizer(file->view());
+            tokenizer.enableStructuralIndex();
 
-            FileUtils::writeFile(outputPath, pretty);
-            std::cout << "✔ Pretty JSON written to: " << outputPath << "\n";
+            JSONHandler ignoreEvents;
+            Parser(tokenizer).parse(ignoreEvents);
+
+            std::cout << "[OK] Valid JSON\n";
             return 0;
         }
 
         // ===============================================================
-        // 2) MINIFY
+        // GET — on-demand: siblings off the path are skipped unparsed,
+        // only the target value is materialized (a snapshot is walked
+        // in place)
         // ===============================================================
-        if (command == "minify") {
-            std::string compact = JSONSerializer::serializeCompact(root);
-            
-            if(argc >= 4 && std::string(argv[3]) == "stdout") {
-                std::cout << compact << "\n";
+        if (command == "get") {
+            if (argc < 4) {
+                std::cerr << "❌ Missing path.\n";
+                return 1;
+            }
+
+            std::string path = argv[3];
+            auto parsedPath = JSONPath::parse(path);
+
+            auto file = mapInput(nullptr);
+            if (JSONSnapshot::isSnapshot(file->view())) {
+                JSONSnapshot snapshot = JSONSnapshot::open(file);
+                JSONPrinter::print(JSONNavigator::get(snapshot.root(), parsedPath));
+                std::cout << "\n";
                 return 0;
             }
-            std::string outputPath =
-                inputPath.substr(0, inputPath.find_last_of('.')) + "_minified.json";
 
-            FileUtils::writeFile(outputPath, compact);
-            std::cout << "✔ Minified JSON written to: " << outputPath << "\n";
+            ValueSpan span = JSONCursor(file->view()).locate(parsedPath);
+            JSONDocument result = JSONDocument::parse(file, span);
+
+            JSONPrinter::print(result.root());
+            std::cout << "\n";
+
             return 0;
         }
 
+        std::unique_ptr<ThreadPool> pool;
+        if (parallel)
+            pool = std::make_unique<ThreadPool>();
+
         // ===============================================================
-        // 3) VALIDATE
+        // COMPILE — parse once into a binary snapshot that the read-only
+        // commands then load without tokenizing or parsing
         // ===============================================================
-        if (command == "validate") {
-            std::cout << "[OK] Valid JSON\n";
+        if (command == "compile") {
+            if (argc < 4) {
+                std::cerr << "❌ Missing output path.\n";
+                return 1;
+            }
+            std::string outputPath = argv[3];
+
+            auto file = FileUtils::mapFile(inputPath);
+            rejectSnapshot(file->view(), command);
+            JSONDocument doc = parallel ? ParallelParser::parse(file, *pool)
+                                        : JSONDocument::parse(file);
+
+            std::string bytes = JSONSnapshot::compile(doc.root());
+            writeOutput(outputPath, [&bytes](JSONWriter& out) { out.put(bytes); });
+
+            std::cout << "✔ Snapshot written to: " << outputPath << " (" << bytes.size() << " bytes)\n";
             return 0;
         }
 
         // ===============================================================
-        // 4) SHOW
+        // 1) PRETTY / MINIFY — parser events are re-serialized as they
+        // arrive and streamed to the output: no tree is built
+        // (--parallel parses into a document first, then writes it)
         // ===============================================================
-        if (command == "show") {
-            JSONPrinter::print(root, 0);
-            std::cout << "\n";
+        if (command == "pretty" || command == "minify") {
+            bool pretty = command == "pretty";
+            bool toStdout = argc >= 4 && std::string(argv[3]) == "stdout";
+            std::string outputPath = toStdout ? std::string()
+                : inputPath.substr(0, inputPath.find_last_of('.')) + (pretty ? "_pretty.json" : "_minified.json");
+
+            auto file = mapInput(pool.get());
+            writeOutput(outputPath, [&](JSONWriter& out) {
+                if (JSONSnapshot::isSnapshot(file->view())) {
+                    JSONSnapshot snapshot = JSONSnapshot::open(file);
+                    if (pretty)
+                        JSONSerializer::write(snapshot.root(), out);
+                    else
+                        JSONSerializer::writeCompact(snapshot.root(), out);
+                    return;
+                }
+
+                if (parallel) {
+                    JSONDocument doc = ParallelParser::parse(file, *pool);
+                    if (pretty)
+                        JSONSerializer::write(doc.root(), out);
+                    else
+                        JSONSerializer::writeCompact(doc.root(), out);
+                    return;
+                }
+
+                Tokenizer tokenizer(file->view());
+                tokenizer.enableStructuralIndex();
+                SerializingHandler transcode(out, pretty);
+                Parser(tokenizer).parse(transcode);
+            });
+
+            if (toStdout)
+                std::cout << "\n";
+            else
+                std::cout << "✔ " << (pretty ? "Pretty" : "Minified") << " JSON written to: " << outputPath << "\n";
             return 0;
         }
 
         // ===============================================================
-        // 5) GET
+        // SET — the file is validated with a SAX pass, the target's
+        // byte span is found by skip-scanning, as in get, and only that
+        // range is replaced: the rest of the file stays byte-identical
+        // and no tree is built or re-serialized
         // ===============================================================
-        if (command == "get") {
-            if (argc < 4) {
-                std::cerr << "❌ Missing path.\n";
+        if (command == "set") {
+            if (argc < 5) {
+                std::cerr << "❌ Missing path or value.\n";
                 return 1;
             }
 
-            std::string path = argv[3];
-            auto parsedPath = JSONPath::parse(path);
-            JSONValue& result = JSONNavigator::get(root, parsedPath);
+            auto parsedPath = JSONPath::parse(argv[3]);
+            std::string replacement = JSONSerializer::serializeCompact(JSONNavigator::valueFromString(argv[4]));
+            bool toStdout = argc >= 6 && std::string(argv[5]) == "stdout";
 
-            JSONPrinter::print(result);
-            std::cout << "\n";
+            auto file = FileUtils::mapFile(inputPath);
+            rejectSnapshot(file->view(), command);
+            ValueSpan span = JSONCursor(file->view()).locateChecked(parsedPath);
+
+            if (toStdout) {
+                std::string_view text = file->view();
+                std::cout << text.substr(0, span.begin) << replacement << text.substr(span.end);
+                return 0;
+            }
 
+            file.reset();   // unmapped before the file is rewritten
+            FileUtils::replaceRange(inputPath, span.begin, span.end, replacement);
+
+            std::cout << "✔ Updated value and saved to " << inputPath << "\n";
             return 0;
         }
 
         // ===============================================================
-        // 6) SET
+        // PATCH — every operation of an RFC 6902 patch is applied to one
+        // parsed tree, which is then serialized and written once
         // ===============================================================
-        if (command == "set") {
-            if (argc < 5) {
-                std::cerr << "❌ Missing path or value.\n";
+        if (command == "patch") {
+            if (argc < 4) {
+                std::cerr << "❌ Missing patch file.\n";
                 return 1;
             }
+            std::string patchPath = argv[3];
+            bool toStdout = argc >= 5 && std::string(argv[4]) == "stdout";
+
+            JSONValue patch;
+            try {
+                patch = JSONDocument::parse(FileUtils::mapFile(patchPath)).root().toValue();
+            } catch (const JSONParseError& e) {
+                throw std::runtime_error("Patch file " + patchPath + " is not valid JSON (line "
+                    + std::to_string(e.line) + ", column " + std::to_string(e.column) + "): " + e.what());
+            }
 
-            std::string path = argv[3];
-            std::string newValueStr = argv[4];
+            JSONValue root;
+            {
+                auto file = FileUtils::mapFile(inputPath);
+                rejectSnapshot(file->view(), command);
+                JSONDocument doc = parallel ? ParallelParser::parse(std::move(file), *pool)
+                                            : JSONDocument::parse(std::move(file));
+                root = doc.root().toValue();
+            }
 
-            auto parsedPath = JSONPath::parse(path);
-            JSONValue& target = JSONNavigator::get(root, parsedPath);
+            size_t applied = 0;
+            try {
+                applied = JSONPatch::apply(root, patch);
+            } catch (const std::runtime_error& e) {
+                std::cerr << "\n❌ Patch failed, " << inputPath << " left unchanged:\n";
+                std::cerr << "   " << e.what() << "\n";
+                return 1;
+            }
+            // Streamed: the pretty text of a deep document is far larger
+            // than the tree
+            writeOutput(toStdout ? std::string() : inputPath,
+                        [&root](JSONWriter& out) { JSONSerializer::write(root, out); });
 
-            // auto-detect type
-            target = parseValueFromString(newValueStr);
+            if (toStdout) {
+                std::cout << "\n";
+                return 0;
+            }
+
+            std::cout << "✔ Applied " << applied << " operations and saved to " << inputPath << "\n";
+            return 0;
+        }
 
-            std::string updated = JSONSerializer::serialize(root);
-            if(argc >= 6 && std::string(argv[5]) == "stdout") {
-                std::cout << updated << "\n";
+        // ----------- Map + Tokenize + Parse (single pass) -----------
+        // "show" only reads the tree, so the file is memory-mapped and
+        // parsed in place into an arena-backed JSONDocument (cheap to
+        // build, freed in one shot). --parallel splits a root array
+        // across the thread pool. A snapshot is shown straight from the
+        // mapping.
+        JSONDocument doc;
+        {
+            auto file = command == "show" ? mapInput(pool.get()) : FileUtils::mapFile(inputPath);
+            if (command == "show" && JSONSnapshot::isSnapshot(file->view())) {
+                JSONSnapshot snapshot = JSONSnapshot::open(file);
+                JSONPrinter::print(snapshot.root(), 0);
+                std::cout << "\n";
                 return 0;
             }
-            FileUtils::writeFile(inputPath, updated);
+            doc = parallel ? ParallelParser::parse(std::move(file), *pool)
+                           : JSONDocument::parse(std::move(file));
+        }
+        const DocValue& root = doc.root();
 
-            std::cout << "✔ Updated value and saved to " << inputPath << "\n";
+        // ===============================================================
+        // 2) SHOW
+        // ===============================================================
+        if (command == "show") {
+            JSONPrinter::print(root, 0);
+            std::cout << "\n";
             return 0;
         }
 
@@ -3,222 +3,305 @@
 #include <memory>
 #include <cstdlib>
 #include <sstream>
-#include <charconv>
-
-// Helper: friendly token type name (for messages)
-static std::string tokenTypeName(TokenType t) {
-    switch (t) {
-        case TokenType::LBRACE:   return "'{'";
-        case TokenType::RBRACE:   return "'}'";
-        case TokenType::LBRACKET: return "'['";
-        case TokenType::RBRACKET: return "']'";
-        case TokenType::COLON:    return "':'";
-        case TokenType::COMMA:    return "','";
-        case TokenType::STRING:   return "string";
-        case TokenType::NUMBER:   return "number";
-        case TokenType::TRUE:     return "'true'";
-        case TokenType::FALSE:    return "'false'";
-        case TokenType::NUL:      return "'null'";
-        case TokenType::END_OF_FILE: return "<EOF>";
+
+// ====================================================
+// JSONValue teardown
+// ====================================================
+namespace {
+
+// Moves the containers this value alone owns onto `pending`; plain
+// values are freed with their parent, one level down at most
+void detachChildren(JSONValue& value, std::vector<std::shared_ptr<JSONValue>>& pending) {
+    auto take = [&pending](std::shared_ptr<JSONValue>& child) {
+        if (child && child.use_count() == 1 && (child->isArray() || child->isObject()))
+            pending.push_back(std::move(child));
+    };
+    if (value.isArray()) {
+        for (auto& element : value.asArray())
+            take(element);
+    } else {
+        for (auto& member : value.asObject())
+            take(member.second);
     }
-    return "token";
+}
+
+} // namespace
+
+JSONValue::~JSONValue() {
+    if (!isArray() && !isObject())
+        return;
+
+    std::vector<std::shared_ptr<JSONValue>> pending;
+    detachChildren(*this, pending);
+    while (!pending.empty()) {
+        std::shared_ptr<JSONValue> node = std::move(pending.back());
+        pending.pop_back();
+        detachChildren(*node, pending);
+    }   // each node is freed here, its nested containers already taken
+}
+
+Parser::Parser(Tokenizer& tokenizer) : source(&tokenizer) {
+    source->nextToken(lookahead());
 }
 
 bool Parser::isAtEnd() const {
+    if (source)
+        return lookahead().type == TokenType::END_OF_FILE;
     return pos >= tokens.size();
 }
 
-const Token& Parser::peek() const {
-    if (pos >= tokens.size()) {
-        // If no tokens available, provide best-effort position (end of input)
-        if (!tokens.empty()) {
-            const Token& last = tokens.back();
-            throw JSONParseError("Unexpected end of input", last.line, last.column);
-        } else {
-            throw JSONParseError("Unexpected end of input", 1, 1);
-        }
+// Reports running out of tokens at the position of the last token seen
+// (best-effort position for an error at the end of the input)
+void Parser::throwEndOfInput(const std::string& message) const {
+    if (source) {
+        if (consumedAny)
+            throw JSONParseError(message, consumed().line, consumed().column);
+        throw JSONParseError(message, 1, 1);
     }
-    return tokens[pos];
+    if (!tokens.empty()) {
+        const Token& last = tokens.back();
+        throw JSONParseError(message, last.line, last.column);
+    }
+    throw JSONParseError(message, 1, 1);
 }
 
-const Token& Parser::advance() {
-    if (pos >= tokens.size()) {
-        if (!tokens.empty()) {
-            const Token& last = tokens.back();
-            throw JSONParseError("Unexpected end of input", last.line, last.column);
-        } else {
-            throw JSONParseError("Unexpected end of input", 1, 1);
-        }
-    }
-    return tokens[pos++];
+const Token& Parser::peek() const {
+    if (isAtEnd())
+        throwEndOfInput("Unexpected end of input");
+    return source ? lookahead() : tokens[pos];
 }
 
-void Parser::expect(TokenType type, const std::string& expectedMessage) {
-    if (isAtEnd() || peek().type != type) {
-        if (isAtEnd()) {
-            if (!tokens.empty()) {
-                const Token& last = tokens.back();
-                throw JSONParseError(expectedMessage + " but reached end of input", last.line, last.column);
-            } else {
-                throw JSONParseError(expectedMessage + " but reached end of input", 1, 1);
-            }
-        } else {
-            const Token& t = peek();
-            std::ostringstream ss;
-            ss << expectedMessage << " but found " << tokenTypeName(t.type);
-            throw JSONParseError(ss.str(), t.line, t.column);
-        }
-    }
-    advance();
+// Returns the consumed token. In streaming mode the reference stays valid
+// only until the next advance(), so callers must read it before moving on.
+Token& Parser::advance() {
+    if (isAtEnd())
+        throwEndOfInput("Unexpected end of input");
+
+    if (!source)
+        return tokens[pos++];
+
+    // The old lookahead becomes the consumed token; the other slot is
+    // refilled with the next one
+    ahead ^= 1;
+    consumedAny = true;
+    source->nextToken(lookahead());
+    return slots[ahead ^ 1];
 }
 
-JSONValue Parser::parse() {
-    JSONValue v = parseValue();
-    // Accept if there are trailing tokens that aren't just EOF-like — if extra tokens present, it's an error.
-    if (!isAtEnd()) {
+void Parser::expect(TokenType type, const char* expectedMessage) {
+    if (isAtEnd())
+        throwEndOfInput(std::string(expectedMessage) + " but reached end of input");
+
+    if (peek().type != type) {
         const Token& t = peek();
         std::ostringstream ss;
-        ss << "Unexpected token after root value: " << tokenTypeName(t.type);
+        ss << expectedMessage << " but found " << tokenTypeName(t.type);
         throw JSONParseError(ss.str(), t.line, t.column);
     }
-    return v;
+    advance();
+}
+
+JSONValue Parser::parse() {
+    JSONValueBuilder builder;
+    parse(builder);
+    return builder.takeResult();
 }
 
-JSONValue Parser::parseValue() {
-    if (isAtEnd()) throw JSONParseError("Unexpected end while parsing value", 1, 1);
+// Explicit-stack descent: one small frame per open container replaces
+// the call frames of parseValue → parseObject → parseValue ..., so a
+// deep document costs a few bytes of heap per level, not native stack
+void Parser::parse(JSONHandler& handler) {
+    struct Frame {
+        bool object;
+        size_t count;     // members / elements completed so far
+    };
+    std::vector<Frame> open;
 
-    const Token &t = peek();
-    switch (t.type) {
-        case TokenType::LBRACE:  return parseObject();
-        case TokenType::LBRACKET: return parseArray();
-        case TokenType::STRING: {
-            advance();
-            return JSONValue(t.value);
-        }
-        case TokenType::NUMBER: {
-            advance();
-            double val;
-            
-            // Try fast path with from_chars (C++17)
-            auto result = std::from_chars(t.value.data(), 
-                                         t.value.data() + t.value.size(), 
-                                         val);
-            
-            if (result.ec == std::errc()) {
-                return JSONValue(val);
+    for (;;) {
+        // ---- One value: a scalar, or the start of a container ----
+        if (isAtEnd()) throwEndOfInput("Unexpected end while parsing value");
+
+        const Token &t = peek();
+        switch (t.type) {
+            case TokenType::LBRACE:
+            case TokenType::LBRACKET: {
+                bool object = t.type == TokenType::LBRACE;
+                if (open.size() >= maxDepth)
+                    throw JSONParseError("Nesting deeper than " + std::to_string(maxDepth) + " levels",
+                                         t.line, t.column);
+                advance();
+                if (object)
+                    handler.startObject();
+                else
+                    handler.startArray();
+
+                // empty container
+                TokenType closing = object ? TokenType::RBRACE : TokenType::RBRACKET;
+                if (!isAtEnd() && peek().type == closing) {
+                    advance();
+                    if (object)
+                        handler.endObject(0);
+                    else
+                        handler.endArray(0);
+                    break;
+                }
+
+                open.push_back(Frame{object, 0});
+                if (object)
+                    memberKey(handler);
+                continue;   // first member value / element
             }
-            
-            // Fallback to stod for edge cases
-            try {
-                val = std::stod(t.value);
-                return JSONValue(val);
-            } catch (...) {
-                throw JSONParseError("Invalid number format: " + t.value, t.line, t.column);
+            case TokenType::STRING:
+                handler.string(advance().text());
+                break;
+            case TokenType::NUMBER: {
+                const Token& number = advance();    // converted by the tokenizer
+                if (number.integral)
+                    handler.integer(number.integer);
+                else
+                    handler.number(number.number);
+                break;
             }
+            case TokenType::TRUE:
+                advance();
+                handler.boolean(true);
+                break;
+            case TokenType::FALSE:
+                advance();
+                handler.boolean(false);
+                break;
+            case TokenType::NUL:
+                advance();
+                handler.null();
+                break;
+            default:
+                throw JSONParseError("Unexpected token when parsing value: " + tokenTypeName(t.type), t.line, t.column);
         }
-        case TokenType::TRUE:
-            advance();
-            return JSONValue(true);
-        case TokenType::FALSE:
-            advance();
-            return JSONValue(false);
-        case TokenType::NUL:
-            advance();
-            return JSONValue(nullptr);
-        default:
-            throw JSONParseError("Unexpected token when parsing value: " + tokenTypeName(t.type), t.line, t.column);
-    }
-}
 
-JSONValue Parser::parseObject() {
-    // consume '{'
-    expect(TokenType::LBRACE, "Expected '{' to start object");
-
-    JSONObject object; 
+        // ---- After a value: ',' continues its container, a closing
+        // bracket completes it (which completes a value one level up) ----
+        for (;;) {
+            if (open.empty()) {
+                // Accept if there are trailing tokens that aren't just EOF-like — if extra tokens present, it's an error.
+                if (!isAtEnd()) {
+                    const Token& extra = peek();
+                    std::ostringstream ss;
+                    ss << "Unexpected token after root value: " << tokenTypeName(extra.type);
+                    throw JSONParseError(ss.str(), extra.line, extra.column);
+                }
+                return;
+            }
 
-    // empty object
-    if (!isAtEnd() && peek().type == TokenType::RBRACE) {
-        advance();
-        return JSONValue(object);
-    }
+            Frame& top = open.back();
+            top.count++;
 
-    while (true) {
-        if (isAtEnd()) {
-            throw JSONParseError("Unterminated object — expected string key or '}'", 1, 1);
-        }
+            // comma or end
+            if (!isAtEnd() && peek().type == TokenType::COMMA) {
+                advance(); // consume comma and continue
+                if (top.object)
+                    memberKey(handler);
+                break;
+            }
 
-        if (peek().type != TokenType::STRING) {
-            const Token &t = peek();
-            throw JSONParseError("Expected string as object key", t.line, t.column);
-        }
+            TokenType closing = top.object ? TokenType::RBRACE : TokenType::RBRACKET;
+            if (!isAtEnd() && peek().type == closing) {
+                advance();
+                Frame done = top;
+                open.pop_back();
+                if (done.object)
+                    handler.endObject(done.count);
+                else
+                    handler.endArray(done.count);
+                continue;
+            }
 
-        // key
-        const Token &keyTok = peek();
-        std::string key = keyTok.value;
-        advance(); // consume key
-
-        // colon
-        expect(TokenType::COLON, "Expected ':' after object key");
-
-        // value
-        JSONValue value = parseValue();
-        object.emplace(std::move(key), std::make_shared<JSONValue>(std::move(value)));
-
-        // comma or end
-        if (!isAtEnd() && peek().type == TokenType::COMMA) {
-            advance(); // consume comma and continue
-            continue;
-        } else if (!isAtEnd() && peek().type == TokenType::RBRACE) {
-            advance(); // consume '}'
-            break;
-        } else {
             if (isAtEnd()) {
-                throw JSONParseError("Unterminated object — expected ',' or '}'", 1, 1);
-            } else {
-                const Token &t = peek();
-                throw JSONParseError("Expected ',' or '}' after object pair", t.line, t.column);
+                throw JSONParseError(top.object ? "Unterminated object — expected ',' or '}'"
+                                                : "Unterminated array — expected ',' or ']'", 1, 1);
             }
+            const Token &bad = peek();
+            throw JSONParseError(top.object ? "Expected ',' or '}' after object pair"
+                                            : "Expected ',' or ']' after array element", bad.line, bad.column);
         }
     }
-
-    return JSONValue(object);
 }
 
-JSONValue Parser::parseArray() {
-    // consume '['
-    expect(TokenType::LBRACKET, "Expected '[' to start array");
+// The key and ':' of the next object member (its value follows)
+void Parser::memberKey(JSONHandler& handler) {
+    if (isAtEnd()) {
+        throw JSONParseError("Unterminated object — expected string key or '}'", 1, 1);
+    }
+
+    if (peek().type != TokenType::STRING) {
+        const Token &t = peek();
+        throw JSONParseError("Expected string as object key", t.line, t.column);
+    }
+
+    // key (reported before the next advance() replaces the token)
+    handler.key(advance().text());
 
-    JSONArray arr; 
+    // colon
+    expect(TokenType::COLON, "Expected ':' after object key");
+}
 
-    // empty array
-    if (!isAtEnd() && peek().type == TokenType::RBRACKET) {
-        advance();
-        return JSONValue(arr);
+// ====================================================
+// JSONValueBuilder
+// ====================================================
+void JSONValueBuilder::addValue(JSONValue value) {
+    if (stack.empty()) {
+        result = std::move(value);
+        return;
     }
 
-    while (true) {
-        JSONValue v = parseValue();
-        arr.push_back(std::make_shared<JSONValue>(std::move(v)));
-
-        // comma or end
-        if (!isAtEnd() && peek().type == TokenType::COMMA) {
-            advance();
-            continue;
-        } else if (!isAtEnd() && peek().type == TokenType::RBRACKET) {
-            advance();
-            break;
-        } else {
-            if (isAtEnd()) {
-                throw JSONParseError("Unterminated array — expected ',' or ']'", 1, 1);
-            } else {
-                const Token &t = peek();
-                throw JSONParseError("Expected ',' or ']' after array element", t.line, t.column);
-            }
-        }
+    Frame& top = stack.back();
+    if (top.container.isArray()) {
+        top.container.asArray().push_back(std::make_shared<JSONValue>(std::move(value)));
+    } else {
+        top.container.asObject().emplace(std::move(top.pendingKey),
+                                         std::make_shared<JSONValue>(std::move(value)));
     }
+}
+
+void JSONValueBuilder::startObject() {
+    stack.push_back(Frame{JSONValue(JSONObject()), JSONKey()});
+}
+
+void JSONValueBuilder::key(std::string_view name) {
+    stack.back().pendingKey = keys->intern(name);
+}
+
+void JSONValueBuilder::endObject(size_t) {
+    JSONValue done = std::move(stack.back().container);
+    stack.pop_back();
+    addValue(std::move(done));
+}
+
+void JSONValueBuilder::startArray() {
+    stack.push_back(Frame{JSONValue(JSONArray()), JSONKey()});
+}
+
+void JSONValueBuilder::endArray(size_t) {
+    JSONValue done = std::move(stack.back().container);
+    stack.pop_back();
+    addValue(std::move(done));
+}
+
+void JSONValueBuilder::string(std::string_view value) {
+    addValue(JSONValue(std::string(value)));
+}
 
-    return JSONValue(arr);
+void JSONValueBuilder::number(double value) {
+    addValue(JSONValue(value));
 }
 
+void JSONValueBuilder::integer(int64_t value) {
+    addValue(JSONValue(value));
+}
 
+void JSONValueBuilder::boolean(bool value) {
+    addValue(JSONValue(value));
+}
 
+void JSONValueBuilder::null() {
+    addValue(JSONValue(nullptr));
+}
@@ -2,10 +2,28 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 
 #include "../include/tokenizer.h"
 #include "../include/parser.h"
+#include "../include/FileUtils.h"
+#include "../include/DocumentCache.h"
+#include "../include/JSONDocument.h"
+#include "../include/JSONCursor.h"
+#include "../include/NDJSON.h"
+#include "../include/ParallelParser.h"
 #include "../include/JSONSerializer.h"
+#include "../include/JSONWriter.h"
+#include "../include/JSONNavigator.h"
+#include "../include/JSONPatch.h"
+#include "../include/PushParser.h"
+#include "../include/JSONService.h"
+#include "../include/JSONSnapshot.h"
+#include "../include/StructuralIndex.h"
 
 int passedTests = 0;
 int failedTests = 0;
@@ -20,43 +38,83 @@ void test(const std::string& name, bool condition) {
     }
 }
 
-void testParseSuccess(const std::string& name, const std::string& json) {
+// Parses with the token-vector parser, the single-pass streaming parser,
+// the streaming parser over the SIMD structural index and the arena
+// JSONDocument builder; returns how many of the four modes succeeded.
+int parseAllModes(const std::string& json) {
+    int ok = 0;
     try {
         Tokenizer t(json);
         auto tokens = t.tokenize();
         Parser p(tokens);
         p.parse();
-        test(name, true);
-    } catch (...) {
-        test(name, false);
-    }
-}
-
-void testParseFailure(const std::string& name, const std::string& json) {
+        ok++;
+    } catch (...) {}
     try {
         Tokenizer t(json);
-        auto tokens = t.tokenize();
-        Parser p(tokens);
+        Parser p(t);
         p.parse();
-        test(name, false); // Should have thrown
-    } catch (...) {
-        test(name, true); // Expected to fail
+        ok++;
+    } catch (...) {}
+    try {
+        Tokenizer t(json);
+        t.enableStructuralIndex();
+        Parser p(t);
+        p.parse();
+        ok++;
+    } catch (...) {}
+    try {
+        JSONDocument::parse(json);
+        ok++;
+    } catch (...) {}
+    return ok;
+}
+
+void testParseSuccess(const std::string& name, const std::string& json) {
+    test(name, parseAllModes(json) == 4);
+}
+
+void testParseFailure(const std::string& name, const std::string& json) {
+    test(name, parseAllModes(json) == 0); // every mode should have thrown
+}
+
+// Every SIMD backend available on this CPU must agree with the scalar one
+void testIndexBackends(const std::string& name, const std::string& json) {
+    auto expected = StructuralIndex::build(json.data(), json.size(), StructuralIndex::Backend::Scalar);
+    bool same = true;
+    for (auto b : {StructuralIndex::Backend::SSE42, StructuralIndex::Backend::AVX2}) {
+        if (StructuralIndex::isSupported(b))
+            same = same && StructuralIndex::build(json.data(), json.size(), b) == expected;
     }
+    test(name, same);
 }
 
+// Records SAX events as a compact trace string
+class TraceHandler : public JSONHandler {
+public:
+    std::string trace;
+    void startObject() override { trace += "{"; }
+    void key(std::string_view name) override { trace += "k:" + std::string(name) + " "; }
+    void endObject(size_t n) override { trace += "}" + std::to_string(n) + " "; }
+    void startArray() override { trace += "["; }
+    void endArray(size_t n) override { trace += "]" + std::to_string(n) + " "; }
+    void string(std::string_view value) override { trace += "s:" + std::string(value) + " "; }
+    void number(double value) override { trace += "n:" + JSONUtils::formatNumber(value) + " "; }
+    void boolean(bool value) override { trace += value ? "true " : "false "; }
+    void null() override { trace += "null "; }
+};
+
 void testRoundTrip(const std::string& name, const std::string& json) {
     try {
         Tokenizer t(json);
-        auto tokens = t.tokenize();
-        Parser p(tokens);
+        Parser p(t);
         JSONValue root = p.parse();
         
         std::string serialized = JSONSerializer::serializeCompact(root);
         
         // Parse again
         Tokenizer t2(serialized);
-        auto tokens2 = t2.tokenize();
-        Parser p2(tokens2);
+        Parser p2(t2);
         p2.parse();
         
         test(name, true);
@@ -79,6 +137,7 @@ int main() {
     testParseSuccess("Number negative", "-42");
     testParseSuccess("Number decimal", "3.14");
     testParseSuccess("Number negative decimal", "-3.14");
+    testParseSuccess("Number exponent", "[1e10, 2.5E-3, -0.5e+2, 0e0]");
     testParseSuccess("Boolean true", "true");
     testParseSuccess("Boolean false", "false");
     testParseSuccess("Null", "null");
@@ -93,6 +152,7 @@ int main() {
     testParseSuccess("Escaped form feed", R"("Test\f")");
     testParseSuccess("Escaped carriage return", R"("Test\r")");
     testParseSuccess("Multiple escapes", R"("\"\\\/\b\f\n\r\t")");
+    testParseSuccess("Unicode escapes", R"(["\u00e9\u4E2D", "\ud83d\ude00", "\u0000"])");
     
     // Objects
     std::cout << "\n--- Objects ---\n";
@@ -115,6 +175,47 @@ int main() {
     testParseSuccess("Nested 10 levels", R"({"a":{"b":{"c":{"d":{"e":{"f":{"g":{"h":{"i":{"j":"deep"}}}}}}}}}}})");
     testParseSuccess("Array nested 10 levels", "[[[[[[[[[[\"deep\"]]]]]]]]]]");
     
+    // Explicit stacks: depth costs heap, not call frames
+    {
+        const size_t depth = 100000;
+        std::string arrays = std::string(depth, '[') + "1" + std::string(depth, ']');
+        std::string objects;
+        for (size_t i = 0; i < depth; i++)
+            objects += "{\"k\":";
+        objects += "null" + std::string(depth, '}');
+
+        bool roundTrip = false;
+        {
+            Tokenizer t(arrays);
+            JSONValue deep = Parser(t).parse();
+            roundTrip = JSONSerializer::serializeCompact(deep) == arrays;
+        }   // and torn down without recursion
+        test("100k-deep arrays parse, serialize and free", roundTrip);
+
+        JSONDocument doc = JSONDocument::parse(objects);
+        const std::string path = "test_suite_deep.snap";
+        std::ofstream(path, std::ios::binary) << JSONSnapshot::compile(doc.root());
+        JSONSnapshot snap = JSONSnapshot::open(FileUtils::mapFile(path));
+        std::remove(path.c_str());
+        test("100k-deep objects convert and compile",
+             JSONSerializer::serializeCompact(doc.root().toValue()) == objects
+             && JSONSerializer::serializeCompact(snap.root()) == objects);
+
+        auto rejected = [](const std::string& json, size_t limit) {
+            Tokenizer t(json);
+            Parser parser(t);
+            parser.setMaxDepth(limit);
+            JSONHandler ignore;
+            PushParser push(ignore);
+            push.setMaxDepth(limit);
+            bool pull = false, pushed = false;
+            try { parser.parse(ignore); } catch (const JSONParseError&) { pull = true; }
+            try { push.feed(json); push.finish(); } catch (const JSONParseError&) { pushed = true; }
+            return pull && pushed;
+        };
+        test("Max depth is enforced", !rejected("[[{\"a\":1}]]", 3) && rejected("[[{\"a\":[]}]]", 3));
+    }
+    
     // Whitespace handling
     std::cout << "\n--- Whitespace ---\n";
     testParseSuccess("Leading whitespace", "   {}");
@@ -141,9 +242,20 @@ int main() {
     testParseFailure("Unterminated object", R"({"key":"value")");
     testParseFailure("Unterminated array", "[1,2,3");
     testParseFailure("Invalid number", "123.45.67");
+    testParseFailure("Bad unicode escape", R"(["\u12G4"])");
+    testParseFailure("Truncated unicode escape", R"(["\u12"])");
+    testParseFailure("Lone high surrogate", R"(["\ud83d x"])");
+    testParseFailure("Lone low surrogate", R"(["\ude00"])");
+    testParseFailure("Leading zero", "[01]");
+    testParseFailure("Lone minus", "[-]");
+    testParseFailure("Empty exponent", "[1e+]");
+    testParseFailure("Empty fraction before exponent", "[1.e5]");
+    testParseFailure("Number out of range", "1e400");
     testParseFailure("Invalid keyword", "tru");
     testParseFailure("Extra closing brace", R"({"key":"value"}})");
     testParseFailure("Extra closing bracket", "[1,2,3]]");
+    testParseFailure("Empty input", "");
+    testParseFailure("Only whitespace", "  \n ");
     
     // Edge cases
     std::cout << "\n--- Edge Cases ---\n";
@@ -154,6 +266,756 @@ int main() {
     testParseSuccess("Small decimal", "0.0001");
     testParseSuccess("Unicode in string", R"("Hello 世界")");
     
+    // Structural index
+    std::cout << "\n--- Structural Index ---\n";
+    {
+        std::string json = R"({"a": [1, "x,y", true], "b\"c": null})";
+        auto idx = StructuralIndex::build(json.data(), json.size());
+        std::vector<uint32_t> expected = {0, 1, 4, 6, 7, 8, 10, 15, 17, 21, 22, 24, 30, 32, 36};
+        test("Index marks token starts only", idx == expected);
+    }
+    testIndexBackends("Backends agree on escapes", R"(["a\\", "b\\\"c", "\\\\\"", "d"])");
+    testIndexBackends("Backends agree across blocks",
+        "[" + std::string(70, ' ') + "\"" + std::string(62, '\\') + "\", 123, {\"k\": false}]");
+    {
+        Tokenizer t("{\n  \"a\": 1,\n  \"b\": [true]\n}");
+        t.enableStructuralIndex();
+        auto tokens = t.tokenize();
+        test("Indexed tokens keep line/column",
+             tokens.size() == 11 && tokens[5].line == 3 && tokens[5].column == 3
+             && tokens[8].column == 9);
+    }
+
+    // Arena document
+    std::cout << "\n--- Arena Document ---\n";
+    {
+        std::string json = R"({"z":1,"a":[true,null,"s"],"m":{"k":-2.5}})";
+        JSONDocument doc = JSONDocument::parse(json);
+        test("Document keeps member order", JSONSerializer::serializeCompact(doc.root()) == json);
+        test("Document lookup", doc.root().find("m") && doc.root().find("m")->find("k")->asNumber() == -2.5
+                                && doc.root().find("missing") == nullptr);
+        JSONValue value = doc.root().toValue();
+        test("Document converts to JSONValue", JSONSerializer::serializeCompact(value["a"]) == R"([true,null,"s"])");
+
+        Arena source;
+        const char* kept = source.copyString("kept");
+        Arena owner(std::move(source));
+        const char* fresh = source.copyString("fresh");
+        test("Moved-from arena allocates its own blocks", source.blockCount() == 1 && owner.blockCount() == 1
+             && std::string_view(kept, 4) == "kept" && std::string_view(fresh, 5) == "fresh");
+    }
+    {
+        std::string json = "[";
+        for (int i = 0; i < 20000; i++)
+            json += std::string(i ? "," : "") + R"({"id":)" + std::to_string(i) + R"(,"tag":"item"})";
+        json += "]";
+        JSONDocument doc = JSONDocument::parse(json);
+        test("Large document lives in a few blocks", doc.root().size() == 20000 && doc.arenaBlocks() < 16);
+    }
+
+    // Zero-copy strings
+    std::cout << "\n--- Zero-Copy Strings ---\n";
+    {
+        JSONDocument doc = JSONDocument::parse(R"({"plain":"abc","esc":"a\nb"})");
+        std::string_view src = doc.sourceText();
+        auto inSource = [&](std::string_view v) {
+            return v.data() >= src.data() && v.data() + v.size() <= src.data() + src.size();
+        };
+        std::string_view plain = doc.root().find("plain")->asString();
+        std::string_view esc = doc.root().find("esc")->asString();
+        test("Escape-free string is a view into the input", plain == "abc" && inSource(plain));
+        test("Escape-free key is a view into the input", inSource(doc.root().member(0).key));
+        test("Escaped string is decoded into owned storage", esc == "a\nb" && !inSource(esc));
+    }
+    {
+        Tokenizer t(R"(["x", "y\tz", 12])");
+        auto tokens = t.tokenize();
+        test("Tokens borrow unless unescaped",
+             tokens[1].borrowed && tokens[1].text() == "x"
+             && !tokens[3].borrowed && tokens[3].text() == "y\tz"
+             && tokens[5].borrowed && tokens[5].text() == "12");
+    }
+
+    // Memory-mapped input
+    std::cout << "\n--- Memory-Mapped Input ---\n";
+    {
+        const std::string path = "test_suite_mapped.json";
+        bool ok = true;
+        // 4096 bytes exercises the padded heap fallback on 4 KB pages
+        for (size_t size : {size_t(0), size_t(100), size_t(4096)}) {
+            std::string json = size ? "[" + std::string(size - 2, ' ') + "]" : "";
+            FileUtils::writeFile(path, json);
+            auto file = FileUtils::mapFile(path);
+            bool padded = true;
+            for (size_t i = 0; i < MappedFile::padding; i++)
+                padded = padded && file->data()[file->size() + i] == '\0';
+            ok = ok && file->view() == json && padded;
+        }
+        test("Mapped view matches file and is zero-padded", ok);
+
+        FileUtils::writeFile(path, R"({"k":["v",1]})");
+        JSONDocument doc = JSONDocument::parse(FileUtils::mapFile(path));
+        std::remove(path.c_str());
+        test("Document parses a mapped file", doc.root().find("k")->size() == 2
+             && (*doc.root().find("k"))[0].asString() == "v");
+    }
+
+    // SAX events
+    std::cout << "\n--- SAX Handler ---\n";
+    {
+        Tokenizer t(R"({"a":[1,"x\ty",{}],"b":null,"c":false})");
+        TraceHandler h;
+        Parser(t).parse(h);
+        test("Events arrive in document order",
+             h.trace == "{k:a [n:1 s:x\ty {}0 ]3 k:b null k:c false }3 ");
+    }
+    {
+        Tokenizer t(R"([1,2,{"k":"v"}] 3)");
+        JSONHandler ignoreEvents;
+        bool threw = false;
+        try { Parser(t).parse(ignoreEvents); } catch (const JSONParseError&) { threw = true; }
+        test("SAX parse still rejects trailing tokens", threw);
+    }
+
+    // On-demand cursor
+    std::cout << "\n--- Cursor ---\n";
+    {
+        std::string json = "{\"skip\": [1, \"a]\\\"}\", {\"x\": [tru]}],\n"
+                           " \"k\\\"ey\": 5,\n \"users\": [{}, {\"name\": \"Bo\", \"tags\": [true]}]}";
+        JSONCursor cursor(json);
+
+        ValueSpan span = cursor.locate(JSONPath::parse("users[1].name"));
+        test("Cursor finds value past skipped siblings",
+             cursor.slice(span) == "\"Bo\"" && span.line == 3);
+        test("Cursor materializes only the target",
+             cursor.get(JSONPath::parse("users[1].tags")).asArray().size() == 1);
+        test("Cursor matches escaped keys", cursor.get({{false, "k\"ey", 0}}).asNumber() == 5);
+
+        int misses = 0;
+        std::vector<std::vector<PathElement>> paths = {
+            JSONPath::parse("users[2]"), JSONPath::parse("nope"),
+            JSONPath::parse("users.name"), {{false, "k\"ey", 0}, {true, "", 0}}};
+        for (const auto& path : paths) {
+            try { cursor.locate(path); } catch (const std::runtime_error&) { misses++; }
+        }
+        test("Cursor reports missing paths", misses == 4);
+
+        JSONCursor broken("[1, 2,\n {\"a\": tru}]");
+        std::string error;
+        try { broken.get(JSONPath::parse("[2].a")); }
+        catch (const std::runtime_error& e) { error = e.what(); }
+        test("Cursor errors keep whole-file positions", error.find("line 2, column 8") != std::string::npos);
+
+        int rejected = 0;
+        for (const char* bad : {"{\"a\":[1,2}", "{\"a\":1,,\"b\":2}"}) {
+            try { JSONCursor(bad).locateChecked(JSONPath::parse("a")); }
+            catch (const JSONParseError&) { rejected++; }
+        }
+        bool mismatched = false;
+        try { JSONCursor("{\"a\":[1,2}").locate(JSONPath::parse("a")); }
+        catch (const JSONParseError&) { mismatched = true; }
+        test("Spans to splice come only from valid text", rejected == 2 && mismatched);
+    }
+
+    // NDJSON
+    std::cout << "\n--- NDJSON ---\n";
+    {
+        // Enough records for several chunks, so ordering across workers matters
+        std::string text;
+        for (int i = 0; i < 60000; i++)
+            text += "{\"id\": " + std::to_string(i) + ", \"pad\": \"" + std::string(20, 'x') + "\"}\n" + (i % 7 ? "" : "\n");
+
+        ThreadPool pool(4);
+        std::string ids;
+        size_t records = NDJSON::forEachRecord(text, pool,
+            [&text](const ValueSpan& record, std::string& out) {
+                out += JSONUtils::formatNumber(JSONCursor(text.substr(record.begin, record.end - record.begin))
+                                                   .get(JSONPath::parse("id")).asNumber());
+                out += ',';
+            },
+            [&ids](const std::string& chunk) { ids += chunk; });
+
+        std::string expected;
+        for (int i = 0; i < 60000; i++)
+            expected += JSONUtils::formatNumber(i) + ",";
+        test("NDJSON skips blank lines and keeps input order", records == 60000 && ids == expected);
+
+        std::string broken = "[1]\n\n{\"a\": 2}\n{\"a\": }\n[3]\n";
+        int line = 0, column = 0;
+        try {
+            NDJSON::forEachRecord(broken, pool,
+                [&broken](const ValueSpan& record, std::string&) {
+                    Tokenizer tokenizer(std::string_view(broken).substr(0, record.end));
+                    tokenizer.seek(record.begin, record.line, record.lineStart);
+                    Parser(tokenizer).parse();
+                },
+                [](const std::string&) {});
+        } catch (const JSONParseError& e) {
+            line = e.line;
+            column = e.column;
+        }
+        test("NDJSON errors report the global line", line == 4 && column == 7);
+    }
+
+    // Parallel root array
+    std::cout << "\n--- Parallel Array ---\n";
+    {
+        // Large enough for several ranges; strings contain brackets and commas
+        std::string json = "[\n";
+        for (int i = 0; i < 20000; i++)
+            json += std::string(i ? ",\n" : "") + "  {\"id\": " + std::to_string(i) + ", \"s\": \"[x], {\\\"y\\\"}\", \"a\": [[1], {}]}";
+        json += "\n]\n";
+
+        ThreadPool pool(4);
+        Tokenizer t(json);
+        std::string serial = JSONSerializer::serializeCompact(Parser(t).parse());
+        test("Parallel JSONValue matches serial parse",
+             JSONSerializer::serializeCompact(ParallelParser::parse(json, pool)) == serial);
+
+        const std::string path = "test_suite_parallel.json";
+        FileUtils::writeFile(path, json);
+        JSONDocument doc = ParallelParser::parse(FileUtils::mapFile(path), pool);
+        test("Parallel document keeps element order",
+             doc.root().size() == 20000 && doc.root()[12345].find("id")->asNumber() == 12345
+             && JSONSerializer::serializeCompact(doc.root()) == JSONSerializer::serializeCompact(JSONDocument::parse(json).root()));
+
+        // Error deep inside a late element, and a malformed top level
+        std::string broken = json;
+        broken.replace(broken.rfind("[[1]"), 4, "[[1}");
+        int ok = 0;
+        for (const std::string& bad : {broken, std::string("[1, 2 3]"), json + "x"}) {
+            std::string serialError, parallelError;
+            try { Tokenizer st(bad); Parser(st).parse(); } catch (const std::exception& e) { serialError = e.what(); }
+            try { ParallelParser::parse(bad, pool); } catch (const std::exception& e) { parallelError = e.what(); }
+            if (!serialError.empty() && serialError == parallelError)
+                ok++;
+        }
+        int line = 0;
+        try { ParallelParser::parse(broken, pool); } catch (const JSONParseError& e) { line = e.line; }
+        test("Parallel errors match serial ones", ok == 3 && line == 20001);
+        std::remove(path.c_str());
+    }
+
+    // Buffer-based serializer
+    std::cout << "\n--- Serializer ---\n";
+    {
+        std::string json = R"({"b":[1,2.5,[],{}],"a":{"x\ny":"q\"\t","n":null,"t":true},"e":[]})";
+        JSONDocument doc = JSONDocument::parse(json);
+
+        bool same = true;
+        for (bool pretty : {false, true}) {
+            JSONWriter out;
+            SerializingHandler transcode(out, pretty);
+            Tokenizer t(json);
+            Parser(t).parse(transcode);
+            std::string expected = pretty ? JSONSerializer::serialize(doc.root())
+                                          : JSONSerializer::serializeCompact(doc.root());
+            same = same && out.str() == expected;
+        }
+        test("SAX transcoding matches the document serializer", same);
+        test("Compact output is unchanged", JSONSerializer::serializeCompact(doc.root()) == json);
+        test("Pretty output layout", JSONSerializer::serialize(JSONDocument::parse(R"({"a":[1,{}],"b":[]})").root())
+             == "{\n  \"a\": [\n    1,\n    {\n    }\n  ],\n  \"b\": [\n  ]\n}");
+
+        std::string sunk;
+        size_t flushes = 0;
+        {
+            JSONWriter out([&](std::string_view chunk) { sunk += chunk; flushes++; }, 16);
+            JSONSerializer::write(doc.root(), out);
+            out.flush();
+        }
+        test("Writer sink receives the output in order",
+             sunk == JSONSerializer::serialize(doc.root()) && flushes > 1);
+    }
+
+    // String lexing: \u decoding and escapes at every vector block offset
+    std::cout << "\n--- String Decoding ---\n";
+    {
+        Tokenizer u(R"("caf\u00e9 \u20AC \uD83D\uDE00 \/")");
+        test("Unicode escapes decode to UTF-8", u.nextToken().text() == "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 /");
+
+        bool decoded = true;
+        for (size_t length = 1; length <= 80; length++) {
+            for (size_t at = 0; at < length; at++) {
+                std::string raw(length, 'a');
+                std::string expected = raw;
+                raw.replace(at, 1, "\\n");
+                expected[at] = '\n';
+                std::string json = "\"" + raw + "\"";
+                Tokenizer t(json);
+                decoded = decoded && t.nextToken().text() == expected;
+            }
+        }
+        test("Escapes decoded at every block offset", decoded);
+
+        Tokenizer lines("\"a\nb\\tc\nd\" x");
+        lines.nextToken();
+        bool lineKept = false;
+        try { lines.nextToken(); } catch (const std::runtime_error& e) {
+            lineKept = std::string(e.what()).find("line 3, column 4") != std::string::npos;
+        }
+        test("Raw newlines inside strings keep line numbers", lineKept);
+    }
+
+    // Key interning
+    std::cout << "\n--- Key Interning ---\n";
+    {
+        Tokenizer t(R"([{"id":1,"name":"a"},{"name":"b","id":2}])");
+        JSONValue root = Parser(t).parse();
+        const JSONObject& first = root.asArray()[0]->asObject();
+        const JSONObject& second = root.asArray()[1]->asObject();
+        test("Repeated keys share one entry", first.find("id")->first.sharesStorageWith(second.find("id")->first)
+             && first.find("name")->first.sharesStorageWith(second.find("name")->first));
+
+        root[1]["extra"] = JSONValue(true);
+        test("Lookups and inserts with plain strings", JSONNavigator::get(root, JSONPath::parse("[1].name")).asString() == "b"
+             && root[1]["extra"].asBool() && root[1].asObject().size() == 3);
+
+        JSONDocument doc = JSONDocument::parse(R"([{"k":1},{"k":2}])");
+        JSONValue copy = doc.root().toValue();
+        test("Document copies intern their keys", copy[0].asObject().begin()->first.sharesStorageWith(
+             copy[1].asObject().begin()->first));
+    }
+
+    // Flat, insertion-ordered objects
+    std::cout << "\n--- Object Layout ---\n";
+    {
+        Tokenizer t(R"({"b":1,"a":2,"c":{"z":0,"y":1}})");
+        JSONValue root = Parser(t).parse();
+        test("Members keep input order", JSONSerializer::serializeCompact(root) == R"({"b":1,"a":2,"c":{"z":0,"y":1}})");
+
+        root["new"] = JSONValue(nullptr);
+        test("Inserted members go last", JSONSerializer::serializeCompact(root) == R"({"b":1,"a":2,"c":{"z":0,"y":1},"new":null})");
+
+        // Past the threshold lookups go through the hash index
+        std::string wide = "{";
+        for (int i = 0; i < 200; i++)
+            wide += "\"k" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+        wide += "\"k7\":-1}";
+        Tokenizer w(wide);
+        JSONValue big = Parser(w).parse();
+        bool found = big.asObject().size() == 200;
+        for (int i = 0; i < 200; i++)
+            found = found && big["k" + std::to_string(i)].asInteger() == i;
+        test("Wide objects find every key", found && big.asObject().count("k200") == 0);
+        test("Duplicate keys keep the first value", big["k7"].asInteger() == 7
+             && JSONNavigator::get(root, JSONPath::parse("c.y")).asInteger() == 1);
+    }
+
+    // Compiled snapshots
+    std::cout << "\n--- Snapshot ---\n";
+    {
+        const std::string path = "test_suite_snapshot.snap";
+        auto load = [&path](const std::string& bytes) {
+            std::ofstream(path, std::ios::binary) << bytes;
+            auto file = FileUtils::mapFile(path);
+            std::remove(path.c_str());
+            return JSONSnapshot::open(file);
+        };
+
+        std::string json = R"({"name":"caf\u00e9 \"q\"","n":[1,-2.5,9007199254740993,true,null,[],{}],)"
+                           R"("rows":[{"id":1,"tag":"a"},{"id":2,"tag":"b"}],"empty":""})";
+        JSONDocument doc = JSONDocument::parse(json);
+        std::string bytes = JSONSnapshot::compile(doc.root());
+        JSONSnapshot snapshot = load(bytes);
+
+        test("Snapshot serializes like the document",
+             JSONSerializer::serializeCompact(snapshot.root()) == JSONSerializer::serializeCompact(doc.root())
+             && JSONSerializer::serialize(snapshot.root()) == JSONSerializer::serialize(doc.root()));
+
+        SnapValue root = snapshot.root();
+        test("Snapshot lookups", root.find("name")->asString() == "caf\xC3\xA9 \"q\""
+             && (*root.find("n"))[2].asInteger() == 9007199254740993LL
+             && JSONNavigator::get(root, JSONPath::parse("rows[1].tag")).asString() == "b"
+             && !root.find("missing"));
+
+        test("Text is not a snapshot", !JSONSnapshot::isSnapshot(json) && JSONSnapshot::isSnapshot(bytes));
+
+        // Truncation is caught on open, bad offsets when followed
+        bool truncated = false, outOfRange = false, backwards = false;
+        try { load(bytes.substr(0, bytes.size() - 1)); } catch (const std::runtime_error&) { truncated = true; }
+
+        std::string bad = bytes;
+        std::memset(&bad[40], 0xFF, 8);            // root record payload
+        try { load(bad).root().find("name"); } catch (const std::runtime_error&) { outOfRange = true; }
+
+        bad = bytes;
+        std::memset(&bad[40], 0, 8);               // root members "at" the header
+        try { load(bad).root().member(0); } catch (const std::runtime_error&) { backwards = true; }
+        test("Corrupt snapshots are rejected", truncated && outOfRange && backwards);
+    }
+
+    // On-disk document cache
+    std::cout << "\n--- Document Cache ---\n";
+    {
+        const std::string path = "test_suite_cached.json";
+        DocumentCache cache(std::filesystem::temp_directory_path() / "test_suite_cache");
+        auto name = [](const std::shared_ptr<const MappedFile>& file) {
+            return JSONSnapshot::open(file).root().find("v")->asString();
+        };
+
+        FileUtils::writeFile(path, R"({"v":"first"})");
+        auto compiled = cache.map(path);
+        auto reused = cache.map(path);
+        test("Unchanged file is served from the cache", JSONSnapshot::isSnapshot(reused->view())
+             && name(compiled) == "first" && name(reused) == "first");
+
+        FileUtils::writeFile(path, R"({"v":"second, longer"})");
+        bool refreshed = name(cache.map(path)) == "second, longer";
+        FileUtils::writeFile(path, R"({"v":)");
+        bool parseError = false;
+        try { cache.map(path); } catch (const JSONParseError&) { parseError = true; }
+        std::remove(path.c_str());
+        std::filesystem::remove_all(cache.directory());
+        test("Changed file is recompiled", refreshed && parseError);
+
+        FileUtils::writeFile(path, R"({"v":"plain"})");
+        auto uncached = DocumentCache(std::filesystem::path(path) / "not_a_directory").map(path);
+        std::remove(path.c_str());
+        test("Unusable cache directory serves the file uncached",
+             !JSONSnapshot::isSnapshot(uncached->view()) && uncached->view() == R"({"v":"plain"})");
+    }
+
+    // set: splice the new value into the located span
+    std::cout << "\n--- In-Place Set ---\n";
+    {
+        const std::string path = "test_suite_set.json";
+        const std::string original = "{\n  \"a\":   1,\n  \"b\": [true, \"x\"]\n}\n";
+        auto splice = [&path](const std::string& target, const std::string& value) {
+            std::string text = FileUtils::readFile(path);
+            ValueSpan span = JSONCursor(text).locate(JSONPath::parse(target));
+            FileUtils::replaceRange(path, span.begin, span.end, value);
+            return FileUtils::readFile(path);
+        };
+
+        std::ofstream(path, std::ios::binary) << original;
+        test("Same-length value is overwritten in place",
+             splice("a", "7") == "{\n  \"a\":   7,\n  \"b\": [true, \"x\"]\n}\n");
+        test("Longer and shorter values move the tail",
+             splice("b[1]", "\"longer\"") == "{\n  \"a\":   7,\n  \"b\": [true, \"longer\"]\n}\n"
+             && splice("b", "0") == "{\n  \"a\":   7,\n  \"b\": 0\n}\n");
+
+        bool kept = false;
+        try {
+            FileUtils::writeReplacing(path, [](std::ostream& out) {
+                out << "{\"partial";
+                throw std::runtime_error("failed midway");
+            });
+        } catch (const std::runtime_error&) {
+            kept = FileUtils::readFile(path) == "{\n  \"a\":   7,\n  \"b\": 0\n}\n";
+        }
+        test("Failed rewrite leaves the old file", kept);
+
+        // Through a symlink the target is rewritten, keeping its mode
+        namespace fs = std::filesystem;
+        const std::string link = "test_suite_set_link.json";
+        std::error_code ec;
+        fs::remove(link, ec);
+        fs::create_symlink(path, link, ec);
+        if (!ec) {
+            fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read, ec);
+            fs::perms before = fs::status(path).permissions();
+            std::string text = FileUtils::readFile(link);
+            ValueSpan span = JSONCursor(text).locate(JSONPath::parse("b"));
+            FileUtils::replaceRange(link, span.begin, span.end, "\"longer\"");
+            test("Rewrite through a symlink keeps the link and the mode",
+                 fs::is_symlink(link) && FileUtils::readFile(path).find("longer") != std::string::npos
+                 && fs::status(path).permissions() == before);
+            fs::remove(link, ec);
+        }
+        std::remove(path.c_str());
+    }
+
+    // Duplicate keys: every builder and the streaming transcode keep the first
+    std::cout << "\n--- Duplicate Keys ---\n";
+    {
+        std::string json = R"({"a":1,"b":{"x":[1],"x":{"y":2}},"a":[2,{"a":3}],"c":3})";
+        for (int i = 0; i < 20; i++)
+            json.insert(json.size() - 1, ",\"k" + std::to_string(i % 18) + "\":" + std::to_string(i));
+        Tokenizer t(json);
+        const std::string tree = JSONSerializer::serializeCompact(Parser(t).parse());
+        const std::string document = JSONSerializer::serializeCompact(JSONDocument::parse(json).root());
+
+        std::string streamed;
+        JSONWriter writer(streamed);
+        SerializingHandler transcode(writer);
+        Tokenizer t2(json);
+        Parser(t2).parse(transcode);
+
+        test("First occurrence wins everywhere", tree.rfind(R"({"a":1,"b":{"x":[1]},"c":3,"k0":0,)", 0) == 0
+             && tree.find("\"k0\":18") == std::string::npos && tree.find("\"k17\":17}") != std::string::npos
+             && document == tree && streamed == tree
+             && JSONCursor(json).get(JSONPath::parse("a")).asInteger() == 1);
+    }
+
+    // Push parser: chunks split anywhere give the same events as Parser
+    std::cout << "\n--- Push Parser ---\n";
+    {
+        auto pushed = [](const std::string& json, size_t chunkSize) {
+            std::string out;
+            JSONWriter writer(out);
+            SerializingHandler handler(writer);
+            PushParser parser(handler);
+            for (size_t i = 0; i < json.size(); i += chunkSize)
+                parser.feed(std::string_view(json).substr(i, chunkSize));
+            parser.finish();
+            return out;
+        };
+        const std::string doc = "{\"name\": \"a \\\"quoted\\\" \\u00e9 \\\\\", \"n\": [-12.5e3, 0, 123456789012],"
+                                " \"ok\": true, \"no\": false, \"nil\": null, \"[{\": {}}";
+        Tokenizer t(doc);
+        const std::string expected = JSONSerializer::serializeCompact(Parser(t).parse());
+        bool same = true;
+        for (size_t size = 1; size <= doc.size(); size++)
+            same = same && pushed(doc, size) == expected;
+        test("Every chunk size matches the pull parser", same);
+
+        size_t seen = 0;
+        JSONValueBuilder builder;
+        PushParser stream(builder, [&seen, &builder] {
+            seen += builder.takeResult().isArray() ? 10 : 1;
+        });
+        for (char c : std::string("1 [2]\n{\"a\":3}"))
+            stream.feed(std::string_view(&c, 1));
+        stream.finish();
+        test("Value streams report each root value", seen == 12 && stream.valueCount() == 3);
+
+        auto errorAt = [](const std::string& json) {
+            JSONHandler ignore;
+            PushParser parser(ignore);
+            try {
+                for (char c : json)
+                    parser.feed(std::string_view(&c, 1));
+                parser.finish();
+            } catch (const JSONParseError& e) {
+                return std::to_string(e.line) + ":" + std::to_string(e.column);
+            }
+            return std::string("none");
+        };
+        test("Errors keep positions across chunks", errorAt("[1,\n  2 3]") == "2:5"
+             && errorAt("{\"a\" 1}") == "1:6" && errorAt("[1, [2]") == "1:8" && errorAt("1 2") == "1:3");
+
+        std::string big = "[";
+        for (int i = 0; i < 2000; i++)
+            big += (i ? ",\"item" : "\"item") + std::to_string(i) + "\"";
+        big += "]";
+        JSONHandler ignore;
+        PushParser parser(ignore);
+        size_t held = 0;
+        for (size_t i = 0; i < big.size(); i += 7) {
+            parser.feed(std::string_view(big).substr(i, 7));
+            held = std::max(held, parser.pendingBytes());
+        }
+        parser.finish();
+        test("Only an unfinished token is held between chunks", held <= 11 && parser.valueCount() == 1);
+    }
+
+    // JSON Patch: RFC 6902 operations on one tree
+    std::cout << "\n--- JSON Patch ---\n";
+    {
+        auto patched = [](const std::string& json, const std::string& ops) {
+            Tokenizer t1(json), t2(ops);
+            JSONValue doc = Parser(t1).parse();
+            JSONPatch::apply(doc, Parser(t2).parse());
+            return JSONSerializer::serializeCompact(doc);
+        };
+        test("Operations apply in order", patched(R"({"a":[1,2],"b":{"c":3}})", R"([
+                {"op":"add","path":"/a/-","value":4},
+                {"op":"add","path":"/a/0","value":0},
+                {"op":"remove","path":"/a/2"},
+                {"op":"replace","path":"/b/c","value":"x"},
+                {"op":"copy","from":"/b","path":"/d"},
+                {"op":"move","from":"/a","path":"/b/a"},
+                {"op":"test","path":"/d","value":{"c":"x"}}
+             ])") == R"({"b":{"c":"x","a":[0,1,4]},"d":{"c":"x"}})");
+        {
+            const size_t depth = 200000;
+            std::string arrays = std::string(depth, '[') + std::string(depth, ']');
+            std::string deep = patched("{\"x\":" + arrays + "}", "[{\"op\":\"copy\",\"from\":\"/x\",\"path\":\"/y\"},"
+                                       "{\"op\":\"test\",\"path\":\"/y\",\"value\":" + arrays + "}]");
+            test("Copy and test handle 200k-deep values",
+                 deep == "{\"x\":" + arrays + ",\"y\":" + arrays + "}");
+        }
+        test("Move onto itself changes nothing",
+             patched(R"({"a":1,"b":2})", R"([{"op":"move","from":"/a","path":"/a"}])") == R"({"a":1,"b":2})");
+        test("Pointer escapes and the root", patched(R"({"a/b":1,"m~n":2})",
+             R"([{"op":"remove","path":"/a~1b"},{"op":"add","path":"/m~0n","value":3}])") == R"({"m~n":3})"
+             && patched("[1]", R"([{"op":"replace","path":"","value":{"x":null}}])") == R"({"x":null})");
+
+        auto fails = [&patched](const std::string& ops) {
+            try { patched(R"({"a":[1],"n":1})", ops); } catch (const std::runtime_error&) { return true; }
+            return false;
+        };
+        test("Failed tests and bad paths throw",
+             !fails(R"([{"op":"test","path":"/n","value":1.0}])")
+             && fails(R"([{"op":"test","path":"/n","value":2}])")
+             && fails(R"([{"op":"remove","path":"/a/01"}])")
+             && fails(R"([{"op":"add","path":"/a/5","value":0}])")
+             && fails(R"([{"op":"move","from":"/a","path":"/a/0"}])")
+             && fails(R"([{"op":"move","from":"/x","path":"/x"}])")
+             && fails(R"([{"op":"bogus","path":"/n"}])"));
+
+        JSONObject wide;
+        for (int i = 0; i < 40; i++)
+            wide.emplace(JSONKey("k" + std::to_string(i)), std::make_shared<JSONValue>(int64_t(i)));
+        wide.erase(wide.find("k3"));
+        wide.erase(wide.find("k30"));
+        test("Erased members keep order and lookups", wide.size() == 38
+             && wide.find("k3") == wide.end() && wide.find("k30") == wide.end()
+             && wide.find("k31")->second->asInteger() == 31 && (wide.begin() + 3)->first.str() == "k4");
+    }
+
+    // HTTP server: request framing and the endpoints (no sockets)
+    std::cout << "\n--- HTTP Service ---\n";
+    {
+        std::string two = "POST /minify?x=1 HTTP/1.1\r\nContent-Length: 3\r\nX-Name:  v \r\n\r\n[1]"
+                          "GET /a HTTP/1.0\r\n\r\n";
+        HTTPRequest first, second, partial;
+        size_t used = HTTPServer::parseRequest(two, first);
+        size_t usedSecond = HTTPServer::parseRequest(std::string_view(two).substr(used), second);
+        test("Pipelined requests are framed by Content-Length",
+             first.method == "POST" && first.path == "/minify" && first.query == "x=1"
+             && first.body == "[1]" && first.header("x-name") == "v" && first.keepAlive
+             && second.path == "/a" && !second.keepAlive && used + usedSecond == two.size()
+             && HTTPServer::parseRequest(two.substr(0, used - 1), partial) == 0);
+
+        auto status = [](const std::string& raw) {
+            HTTPRequest r;
+            try { HTTPServer::parseRequest(raw, r); } catch (const HTTPError& e) { return e.status; }
+            return 200;
+        };
+        test("Bad requests are refused", status("BROKEN\r\n\r\n") == 400
+             && status("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n") == 411
+             && status("GET / HTTP/2.0\r\n\r\n") == 505
+             && status("GET / HTTP/1.1\nHost: x\n\n") == 400);
+
+        auto call = [](const std::string& route, const std::string& body) {
+            HTTPRequest r;
+            r.method = "POST";
+            r.path = route;
+            r.body = body;
+            return JSONService::handle(r);
+        };
+        test("Endpoints answer like the CLI",
+             call("/minify", "{ \"a\" : [1, 2] }").body == R"({"result":"{\"a\":[1,2]}","error":""})"
+             && call("/get", R"({"json":"{\"a\":[5,6]}","path":"a[1]"})").body == R"({"result":"6","error":""})"
+             && call("/set", R"({"json":{"a":1},"path":"a","value":"\"x\""})").body
+                == R"({"result":"{\n  \"a\": \"x\"\n}","error":""})");
+
+        HTTPResponse invalid = call("/validate", "[1,");
+        test("Endpoint errors keep the reply shape", invalid.status == 200
+             && invalid.body.find("JSON Parse Error at line 1") != std::string::npos
+             && call("/get", R"({"json":1})").status == 400 && call("/nope", "").status == 404);
+    }
+
+    // Escaping (vector scan + bulk copy) against a byte-at-a-time reference
+    std::cout << "\n--- Escaping ---\n";
+    {
+        auto reference = [](const std::string& s) {
+            std::string out;
+            char buf[8];
+            for (unsigned char c : s) {
+                if (c == '"') out += "\\\"";
+                else if (c == '\\') out += "\\\\";
+                else if (c == '\n') out += "\\n";
+                else if (c == '\t') out += "\\t";
+                else if (c < 0x20) { std::snprintf(buf, sizeof buf, "\\u%04X", c); out += buf; }
+                else out += char(c);
+            }
+            return out;
+        };
+
+        bool same = true;
+        for (char special : {'"', '\\', '\n', '\t', '\x01', '\x1f'}) {
+            for (size_t length = 1; length <= 80; length++) {
+                for (size_t at = 0; at < length; at++) {
+                    std::string s(length, 'a');
+                    s[at] = special;
+                    same = same && JSONUtils::escapeString(s) == reference(s);
+                }
+            }
+        }
+        test("Escapes found at every block offset", same);
+
+        std::string clean = "caf\xC3\xA9 \xE2\x82\xAC " + std::string(100, 'x') + "\x7f";
+        test("Clean and UTF-8 text is copied unchanged", JSONUtils::escapeString(clean) == clean);
+    }
+
+    // Number formatting
+    std::cout << "\n--- Number Formatting ---\n";
+    {
+        test("Shortest form for fractions", JSONUtils::formatNumber(0.1) == "0.1"
+             && JSONUtils::formatNumber(-2.5) == "-2.5" && JSONUtils::formatNumber(1.0 / 3) == "0.3333333333333333");
+        test("Integers print without a fraction", JSONUtils::formatNumber(42) == "42"
+             && JSONUtils::formatNumber(-9007199254740991.0) == "-9007199254740991");
+        test("Huge values do not overflow", JSONUtils::formatNumber(1e20) == "1e+20"
+             && JSONUtils::formatNumber(-1.7976931348623157e308) == "-1.7976931348623157e+308");
+        test("Non-finite values print as null", JSONUtils::formatNumber(std::nan("")) == "null"
+             && JSONUtils::formatNumber(HUGE_VAL) == "null");
+
+        bool roundTrips = true;
+        double v = 0.000123456789;
+        for (int i = 0; i < 1000; i++, v = v * 1.7320508 + 0.1) {
+            std::string text = JSONUtils::formatNumber(v);
+            roundTrips = roundTrips && std::strtod(text.c_str(), nullptr) == v;
+        }
+        test("Formatted numbers round-trip", roundTrips);
+    }
+
+    // Number parsing
+    std::cout << "\n--- Number Parsing ---\n";
+    {
+        // Fast path and from_chars fallback must both match strtod exactly
+        std::vector<std::string> samples = {
+            "0", "-0", "7", "1e22", "1e23", "9007199254740993", "12345678901234567890123",
+            "0.1", "2.2250738585072014e-308", "4.9e-324", "1.7976931348623157e308",
+            "3.141592653589793238462643383279", "-123.456e-7", "0.000001234", "5E+3",
+            "1e-310", "-1e-400", "1e-400", "2.4e-324", "1234e-330"};
+        double v = 0.000123456789;
+        for (int i = 0; i < 1000; i++, v = v * 1.7320508 + 0.1)
+            samples.push_back(JSONUtils::formatNumber(v));
+
+        bool exact = true;
+        for (const std::string& text : samples) {
+            Tokenizer t(text);
+            Token token = t.nextToken();
+            double expected = std::strtod(text.c_str(), nullptr);
+            exact = exact && token.type == TokenType::NUMBER && token.text() == text
+                    && token.number == expected && std::signbit(token.number) == std::signbit(expected);
+        }
+        test("Numbers convert exactly in the tokenizer", exact);
+
+        Tokenizer t("[1.5e3,-2]");
+        Parser p(t);
+        JSONValue root = p.parse();
+        test("Parser uses the tokenizer's value",
+             root.asArray()[0]->asNumber() == 1500 && root.asArray()[1]->asNumber() == -2);
+    }
+
+    // 64-bit integers
+    std::cout << "\n--- Integers ---\n";
+    {
+        const std::string ids = "[9007199254740993,-9223372036854775808,9223372036854775807,0]";
+        Tokenizer t(ids);
+        JSONValue root = Parser(t).parse();
+        const JSONArray& arr = root.asArray();
+        test("Integer literals stay exact", arr[0]->isInteger() && arr[0]->asInteger() == 9007199254740993LL
+             && arr[1]->asInteger() == INT64_MIN && arr[2]->asInteger() == INT64_MAX && arr[3]->isNumber());
+        test("Integers round-trip through the serializer", JSONSerializer::serializeCompact(root) == ids);
+
+        JSONDocument doc = JSONDocument::parse(ids);
+        test("Document keeps integers exact", doc.root()[0].isInteger() && doc.root()[0].asNumber() == 9007199254740992.0
+             && JSONSerializer::serializeCompact(doc.root()) == ids);
+
+        Tokenizer other("[9223372036854775808,-0,1.0,1e2]");
+        JSONValue doubles = Parser(other).parse();
+        bool allDoubles = true;
+        for (const auto& v : doubles.asArray())
+            allDoubles = allDoubles && v->isNumber() && !v->isInteger();
+        test("Out-of-range, -0, fractions and exponents stay doubles", allDoubles
+             && JSONSerializer::serializeCompact(doubles) == "[9223372036854775808,-0,1,100]");
+    }
+
     // Summary
     std::cout << "\n========================================\n";
     std::cout << "RESULTS:\n";